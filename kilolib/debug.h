@@ -15,37 +15,48 @@
 
 #ifdef DEBUG
 
+#ifdef SIMULATOR
+#include <stdio.h>
+#include "kilolib_host.h"
+
+// On the host every robot shares one terminal, so printf() is routed through
+// the simulator which tags each line with the robot and can silence it.
+#define debug_init()
+#define printf(...) kilo_host_printf(__VA_ARGS__)
+
+#else
+
 #include <stdio.h>
 #include <avr/io.h>
 #include <avr/interrupt.h>
 
 #ifdef NONBLOCKING
-#include "ringbuffer.h"
+#include "ringbuffer_spsc.h"
 
-RB_create(debug_buffer, char, 128);
+SPSC_create(debug_buffer, char, 128);  // characters from printf() to the UART interrupt
 
 static int debug_putchar(char c, FILE *stream) {
-    if (RB_full(debug_buffer)) {
+    if (SPSC_full(debug_buffer)) {
         return -1;
     } else {
-        RB_back(debug_buffer) = c;
-        RB_pushback(debug_buffer);
+        SPSC_back(debug_buffer) = c;
+        SPSC_push(debug_buffer);
         UCSR0B |= (1 << UDRIE0);
         return 0;
     }
 }
 
 ISR(USART_UDRE_vect) {
-    if (RB_empty(debug_buffer)) {
+    if (SPSC_empty(debug_buffer)) {
         UCSR0B &= ~(1 << UDRIE0);
     } else {
-        UDR0 = RB_front(debug_buffer);
-        RB_popfront(debug_buffer);
+        UDR0 = SPSC_front(debug_buffer);
+        SPSC_pop(debug_buffer);
     }
 }
 
 #define debug_init_extra() {\
-    RB_init(debug_buffer);\
+    SPSC_init(debug_buffer);\
 }
 
 #else
@@ -92,6 +103,7 @@ void debug_init() {
     sei();
 }
 
+#endif//SIMULATOR
 
 #else
 
@@ -0,0 +1,253 @@
+/**
+ * @file distance.c
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Distance estimation from IR signal strength, shared by the AVR and host kilolib backends
+ *
+ * Integer versions of the floating point estimate_distance() kilolib had
+ * (kept in distance_reference.h): estimate_distance_scan() scans the
+ * calibration tables, estimate_distance() looks their segments up in
+ * kilo_distance_lut. Both return exactly what it did.
+ *
+ * @version 0.2
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "kilolib.h"
+#include "distance.h"
+
+extern uint16_t kilo_irhigh[14];  // high gain calibration table (defined by the kilolib backend)
+extern uint16_t kilo_irlow[14];   // low gain calibration table (defined by the kilolib backend)
+
+distance_lut_t kilo_distance_lut;
+
+/**
+ * @brief Distance along one gain channel, interpolated between two calibration samples
+ *
+ * Sample i of a table is the reading at 5*i mm (from 33 mm centre to
+ * centre). The reading is taken on the line through samples i-1 and i, as
+ * the floating point estimate_distance() did (see distance_reference.h), and
+ * the result truncated the same way, all in 16-bit integers.
+ *
+ * @param table (kilo_irhigh or kilo_irlow)
+ * @param reading (ADC reading of that channel)
+ * @param i (Sample the reading is above, 1 to 13)
+ * @return uint8_t (Distance in millimeters beyond 33 mm, 255 if samples i-1 and i are equal)
+ */
+static uint8_t interpolate(const uint16_t *table, int16_t reading, uint8_t i) {
+    int16_t slope = (int16_t)table[i] - (int16_t)table[i-1];  // change of the reading over 5 mm
+    int16_t offset = 5*(reading - (int16_t)table[i]);
+    int16_t mm, rest;
+
+    if (slope == 0)
+        return 255;
+    //  (offset + 5*i*slope)/slope rounded toward zero, without its 32-bit numerator
+    mm = 5*i + offset/slope;
+    rest = offset%slope;
+    if (rest && mm > 0 && (rest < 0) != (slope < 0))
+        mm--;
+    else if (rest && mm < 0 && (rest < 0) == (slope < 0))
+        mm++;
+    return mm;
+}
+
+/**
+ * @brief Estimate distance between two robots using IR distance measurements, scanning the calibration tables
+ *
+ * This function estimates the distance between two robots using IR distance measurements.
+ * It takes a pointer to a distance_measurement_t structure as input, which contains
+ * the high and low gain IR distance measurements. It calculates the distance based on
+ * the calibration values stored in the kilo_irlow and kilo_irhigh arrays.
+ * It only uses integer arithmetic, and returns what the floating point version
+ * kilolib used before did (see sim/distance_check.c).
+ *
+ * @param dist (Pointer to the distance_measurement_t structure containing IR distance measurements)
+ * @return uint8_t (The estimated distance between two robots in millimeters)
+ */
+uint8_t estimate_distance_scan(const distance_measurement_t *dist) {
+    uint8_t i;
+    uint8_t index_high = 13;
+    uint8_t index_low = 255;
+    uint8_t dist_high = 255;
+    uint8_t dist_low = 255;
+
+    if (dist->high_gain < 900) {
+        if (dist->high_gain > kilo_irhigh[0]) {
+            dist_high = 0;
+        } else {
+            for (i = 1; i < 14; i++) {
+                if (dist->high_gain > kilo_irhigh[i]) {
+                    index_high = i;
+                    break;
+                }
+            }
+            dist_high = interpolate(kilo_irhigh, dist->high_gain, index_high);
+        }
+    }
+
+    if (dist->high_gain > 700) {
+        if (dist->low_gain > kilo_irlow[0]) {
+            dist_low = 0;
+        } else {
+            for (i = 1; i < 14; i++) {
+                if (dist->low_gain > kilo_irlow[i]) {
+                    index_low = i;
+                    break;
+                }
+            }
+
+            if (index_low == 255)
+                dist_low = 90;
+            else
+                dist_low = interpolate(kilo_irlow, dist->low_gain, index_low);
+        }
+    }
+
+    if (dist_low != 255) {
+        if (dist_high != 255) {
+            //  both weights are below 200 here, so the sum fits 16 bits
+            return 33 + ((uint16_t)dist_high*(uint16_t)(900 - dist->high_gain) +
+                         (uint16_t)dist_low*(uint16_t)(dist->high_gain - 700))/200;
+        } else {
+            return 33 + dist_low;
+        }
+    } else {
+        return 33 + dist_high;
+    }
+}
+
+/**
+ * @brief Segments of the entries of one gain channel
+ *
+ * @param table (kilo_irhigh or kilo_irlow)
+ * @param segments (Receives the entries)
+ * @return uint8_t (1, or 0 if the table does not strictly decrease within the 10-bit readings)
+ */
+static uint8_t lut_build(const uint16_t *table, uint8_t *segments) {
+    uint16_t reading;
+    uint8_t i, k;
+
+    if (table[0] >= 1024)
+        return 0;
+    for (i = 1; i < 14; i++)
+        if (table[i] >= table[i-1])
+            return 0;
+    for (k = 0; k < DISTANCE_LUT_ENTRIES; k++) {
+        reading = (uint16_t)k << DISTANCE_LUT_SHIFT;
+        for (i = 1; i < 14 && reading <= table[i]; i++)
+            ;
+        if (k & 1)
+            segments[k >> 1] |= i << 4;
+        else
+            segments[k >> 1] = i;
+    }
+    return 1;
+}
+
+void distance_lut_init(void) {
+    kilo_distance_lut.ready = lut_build(kilo_irhigh, kilo_distance_lut.high) &&
+                              lut_build(kilo_irlow, kilo_distance_lut.low);
+}
+
+/**
+ * @brief Calibration segment of a reading
+ *
+ * @param table (kilo_irhigh or kilo_irlow)
+ * @param segments (Its entries in kilo_distance_lut)
+ * @param reading (ADC reading of that channel, 0 to table[0])
+ * @return uint8_t (First sample the reading is above, 1 to 13, or DISTANCE_LUT_BEYOND)
+ */
+static inline uint8_t lut_segment(const uint16_t *table, const uint8_t *segments, uint16_t reading) {
+    uint8_t k = reading >> DISTANCE_LUT_SHIFT;
+    uint8_t i = k & 1 ? segments[k >> 1] >> 4 : segments[k >> 1] & 0x0F;
+
+    //  at most a sample or two between the first reading of the entry and this one
+    while (i > 1 && reading > table[i-1])
+        i--;
+    return i;
+}
+
+/**
+ * @brief Distance along one gain channel within a calibration segment
+ *
+ * The same as interpolate() for such a reading: the distance lies in the
+ * last 5 mm before sample i, so its millimeters are counted off by adding
+ * up the width of the segment instead of dividing by it.
+ *
+ * @param table (kilo_irhigh or kilo_irlow, strictly decreasing)
+ * @param reading (ADC reading of that channel, above table[i] and at most table[i-1])
+ * @param i (Segment, 1 to 13)
+ * @return uint8_t (Distance in millimeters beyond 33 mm)
+ */
+static inline uint8_t lut_distance(const uint16_t *table, uint16_t reading, uint8_t i) {
+    uint16_t width = table[i-1] - table[i];  // readings over 5 mm
+    uint16_t offset = 5*(reading - table[i]), step = width;
+    uint8_t mm = 5*i - 1;
+
+    while (offset > step) {
+        step += width;
+        mm--;
+    }
+    return mm;
+}
+
+/**
+ * @brief Estimate distance between two robots using IR distance measurements
+ *
+ * Returns what estimate_distance_scan() does, looking the calibration
+ * segments up in kilo_distance_lut instead of scanning the tables, and
+ * without any division between the calibrated distances (33 to 98 mm).
+ * Without a usable table it scans them.
+ *
+ * @param dist (Pointer to the distance_measurement_t structure containing IR distance measurements)
+ * @return uint8_t (The estimated distance between two robots in millimeters)
+ */
+uint8_t estimate_distance(const distance_measurement_t *dist) {
+    uint8_t i;
+    uint8_t dist_high = 255;
+    uint8_t dist_low = 255;
+    uint16_t sum;
+
+    if (!kilo_distance_lut.ready || dist->high_gain < 0 || dist->low_gain < 0)
+        return estimate_distance_scan(dist);
+
+    if (dist->high_gain < 900) {
+        if (dist->high_gain > kilo_irhigh[0]) {
+            dist_high = 0;
+        } else {
+            i = lut_segment(kilo_irhigh, kilo_distance_lut.high, dist->high_gain);
+            if (i == DISTANCE_LUT_BEYOND)
+                dist_high = interpolate(kilo_irhigh, dist->high_gain, 13);
+            else
+                dist_high = lut_distance(kilo_irhigh, dist->high_gain, i);
+        }
+    }
+
+    if (dist->high_gain > 700) {
+        if (dist->low_gain > kilo_irlow[0]) {
+            dist_low = 0;
+        } else {
+            i = lut_segment(kilo_irlow, kilo_distance_lut.low, dist->low_gain);
+            if (i == DISTANCE_LUT_BEYOND)
+                dist_low = 90;
+            else
+                dist_low = lut_distance(kilo_irlow, dist->low_gain, i);
+        }
+    }
+
+    if (dist_low != 255) {
+        if (dist_high != 255) {
+            sum = (uint16_t)dist_high*(uint16_t)(900 - dist->high_gain) +
+                  (uint16_t)dist_low*(uint16_t)(dist->high_gain - 700);
+            //  sum/200 for any sum up to 255*200, by a multiplication
+            return 33 + (uint8_t)(((uint32_t)sum * 83887UL) >> 24);
+        } else {
+            return 33 + dist_low;
+        }
+    } else {
+        return 33 + dist_high;
+    }
+}
@@ -0,0 +1,55 @@
+/**
+ * @file distance.h
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Table of the calibration segments estimate_distance() looks readings up in, built by the kilolib backends
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef __DISTANCE_H__
+#define __DISTANCE_H__
+
+#include "kilolib.h"
+
+#define DISTANCE_LUT_SHIFT   4                             // log2 of the readings sharing an entry
+#define DISTANCE_LUT_ENTRIES (1024 >> DISTANCE_LUT_SHIFT)  // entries per gain channel
+#define DISTANCE_LUT_BEYOND  14                            // segment of readings at or below sample 13
+
+/**
+ * @brief Calibration segment of the readings of each gain channel.
+ *
+ * Segment i (1 to 13) holds the readings between calibration samples i-1
+ * and i, that is 5*(i-1) to 5*i mm beyond 33 mm. Entry k is the segment of
+ * reading 16*k; a larger reading of the same entry lies in that segment or
+ * one closer. Entries take 4 bits, the even ones in the low half of a byte.
+ */
+typedef struct {
+    uint8_t high[DISTANCE_LUT_ENTRIES / 2];  //  kilo_irhigh segments
+    uint8_t low[DISTANCE_LUT_ENTRIES / 2];   //  kilo_irlow segments
+    uint8_t ready;                           //  1 if both calibration tables strictly decrease, so the entries hold
+} distance_lut_t;
+
+extern distance_lut_t kilo_distance_lut;  // table of the robot, built by distance_lut_init()
+
+/**
+ * @brief Build kilo_distance_lut from kilo_irhigh and kilo_irlow.
+ *
+ * Called by kilo_init() once the calibration tables are read from EEPROM,
+ * and again by whoever changes them. Until then, and for tables that do not
+ * strictly decrease, estimate_distance() scans the tables instead.
+ */
+void distance_lut_init(void);
+
+/**
+ * @brief estimate_distance() scanning the calibration tables, without kilo_distance_lut.
+ *
+ * @param dist (Signal strength measured while receiving a message)
+ * @return uint8_t (Distance in millimeters, as estimate_distance())
+ */
+uint8_t estimate_distance_scan(const distance_measurement_t *dist);
+
+#endif//__DISTANCE_H__
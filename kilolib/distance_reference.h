@@ -0,0 +1,91 @@
+/**
+ * @file distance_reference.h
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief The floating point estimate_distance() kilolib used to ship, kept to check and time the fixed point one against
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef __DISTANCE_REFERENCE_H__
+#define __DISTANCE_REFERENCE_H__
+
+#include "kilolib.h"
+
+extern uint16_t kilo_irhigh[14];  // high gain calibration table
+extern uint16_t kilo_irlow[14];   // low gain calibration table
+
+/**
+ * @brief Estimate distance between two robots using IR distance measurements, in floating point
+ *
+ * The estimate_distance() of kilolib before it moved to fixed point, unchanged:
+ * see distance.c. Used by sim/distance_check.c and the distance benchmark
+ * program only; it pulls the soft-float library into AVR builds.
+ *
+ * @param dist (Pointer to the distance_measurement_t structure containing IR distance measurements)
+ * @return uint8_t (The estimated distance between two robots in millimeters)
+ */
+static inline uint8_t estimate_distance_reference(const distance_measurement_t *dist) {
+    uint8_t i;
+    uint8_t index_high = 13;
+    uint8_t index_low = 255;
+    uint8_t dist_high = 255;
+    uint8_t dist_low = 255;
+
+    if (dist->high_gain < 900) {
+        if (dist->high_gain > kilo_irhigh[0]) {
+            dist_high = 0;
+        } else {
+            for (i = 1; i < 14; i++) {
+                if (dist->high_gain > kilo_irhigh[i]) {
+                    index_high = i;
+                    break;
+                }
+            }
+
+            double slope = (kilo_irhigh[index_high]-kilo_irhigh[index_high-1])/0.5;
+            double b = (double)kilo_irhigh[index_high] - (double)slope*((double)index_high*(double)0.5 + (double)0.0);
+            b = (((((double)dist->high_gain-(double)b)*(double)10)));
+            b = ((int)((int)b/(int)slope));
+            dist_high = b;
+        }
+    }
+
+    if (dist->high_gain > 700) {
+        if (dist->low_gain > kilo_irlow[0]) {
+            dist_low = 0;
+        } else {
+            for (i = 1; i < 14; i++) {
+                if (dist->low_gain > kilo_irlow[i]) {
+                    index_low = i;
+                    break;
+                }
+            }
+
+            if (index_low == 255) {
+                dist_low = 90;
+            } else {
+                double slope = (kilo_irlow[index_low]-kilo_irlow[index_low-1])/0.5;
+                double b = (double)kilo_irlow[index_low] - (double)slope*((double)index_low*(double)0.5 + (double)0.0);
+                b = (((((double)dist->low_gain-(double)b)*(double)10)));
+                b = ((int)((int)b/(int)slope));
+                dist_low = b;
+            }
+        }
+    }
+
+    if (dist_low != 255) {
+        if (dist_high != 255) {
+            return 33 + ((double)dist_high*(900.0-dist->high_gain)+(double)dist_low*(dist->high_gain-700.0))/200.0;
+        } else {
+            return 33 + dist_low;
+        }
+    } else {
+        return 33 + dist_high;
+    }
+}
+
+#endif//__DISTANCE_REFERENCE_H__
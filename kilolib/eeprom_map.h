@@ -0,0 +1,30 @@
+/**
+ * @file eeprom_map.h
+ * @author Team Harvard
+ *
+ * @brief EEPROM addresses of the per-robot calibration data read by kilo_init()
+ * @version 0.1
+ * @date 2023-02-17
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+
+#ifndef __EEPROM_MAP_H__
+#define __EEPROM_MAP_H__
+
+#define EEPROM_OSCCAL         (uint8_t*)0x01
+#define EEPROM_TXMASK         (uint8_t*)0x90
+#define EEPROM_IRLOW          (uint8_t*)0x20
+#define EEPROM_IRHIGH         (uint8_t*)0x50
+#define EEPROM_UID            (uint8_t*)0xB0
+#define EEPROM_LEFT_ROTATE    (uint8_t*)0x05
+#define EEPROM_RIGHT_ROTATE   (uint8_t*)0x09
+#define EEPROM_LEFT_STRAIGHT  (uint8_t*)0x0C
+#define EEPROM_RIGHT_STRAIGHT (uint8_t*)0x14
+#define TX_MASK_MAX   ((1<<0)|(1<<1)|(1<<2)|(1<<6)|(1<<7))
+#define TX_MASK_MIN   ((1<<0))
+
+#define EEPROM_SIZE           1024  // ATmega328P EEPROM size in bytes
+
+#endif//__EEPROM_MAP_H__
@@ -22,18 +22,9 @@
 #include "message_send.h"
 #include "macros.h"
 #include "ohc.h"
-
-#define EEPROM_OSCCAL         (uint8_t*)0x01
-#define EEPROM_TXMASK         (uint8_t*)0x90
-#define EEPROM_IRLOW          (uint8_t*)0x20
-#define EEPROM_IRHIGH         (uint8_t*)0x50
-#define EEPROM_UID            (uint8_t*)0xB0
-#define EEPROM_LEFT_ROTATE    (uint8_t*)0x05
-#define EEPROM_RIGHT_ROTATE   (uint8_t*)0x09
-#define EEPROM_LEFT_STRAIGHT  (uint8_t*)0x0C
-#define EEPROM_RIGHT_STRAIGHT (uint8_t*)0x14
-#define TX_MASK_MAX   ((1<<0)|(1<<1)|(1<<2)|(1<<6)|(1<<7))
-#define TX_MASK_MIN   ((1<<0))
+#include "eeprom_map.h"
+#include "distance.h"
+#include "ringbuffer_spsc.h"
 
 /* Number of clock cycles per bit. */
 #define rx_bitcycles 269
@@ -66,6 +57,19 @@ uint8_t rx_bytevalue;              // value of the current byte being decoded
 volatile uint8_t tx_mask;
 volatile uint16_t kilo_tx_period;
 
+#if !defined(BOOTLOADER) && defined(KILO_RX_DEFERRED)
+/**
+ * @brief Frames received by ISR(ANALOG_COMP_vect) and not yet handed to kilo_message_rx.
+ *
+ * The interrupt pushes, kilo_start() pops (see ringbuffer_spsc.h).
+ */
+typedef struct {
+    message_t msg;
+    distance_measurement_t dist;
+} rx_frame_t;
+static SPSC_create(rx_queue, rx_frame_t, KILO_RX_QUEUE);
+#endif
+
 #ifndef BOOTLOADER
 uint16_t tx_clock;                 // number of timer cycles we have waited
 uint16_t tx_increment;             // number of timer cycles until next interrupt
@@ -79,6 +83,33 @@ uint16_t kilo_irhigh[14];
 uint16_t kilo_irlow[14];
 #endif
 
+#if !defined(BOOTLOADER) && !defined(MESSAGE_SEND_BLOCKING)
+/* Port of the IR led (IR_PORT and IR_DDR of message_send.S). */
+#define tx_port PORTB
+#define tx_ddr DDRB
+/* Number of clock cycles the IR led is lit for a bit, as in the irsend macro of message_send.S. */
+#define tx_pulse_cycles 9
+
+/**
+ * @brief Frame being sent by ISR(TIMER1_COMPB_vect), see tx_start().
+ */
+static message_t tx_msg;
+static volatile enum {
+    TX_IDLE,    //  no frame being sent
+    TX_SENSE,   //  leading start bit sent, waiting for its echo to fade
+    TX_LISTEN,  //  listening for other senders until the leading stop bit
+    TX_DATA,    //  sending the bytes of tx_msg
+    TX_LAST,    //  last stop bit sent
+} tx_state;
+static uint8_t tx_byteindex;       // byte of tx_msg being sent
+static uint8_t tx_bitindex;        // bit of that byte being sent (0 start, 1-8 data, 9 stop)
+static uint16_t tx_bytevalue;      // bits of that byte from tx_bitindex on
+static uint8_t tx_saved_ddr;       // direction of the IR led pins before the frame
+#define tx_busy() (tx_state != TX_IDLE)
+#else
+#define tx_busy() 0
+#endif
+
 /**
  * @brief Enumeration of the possible states of the kilobot.
  * 
@@ -134,6 +165,12 @@ void kilo_init() {
     rx_bytevalue = 0;  // set reception byte value to 0
 
 #ifndef BOOTLOADER
+#ifdef KILO_RX_DEFERRED
+    SPSC_init(rx_queue);  // empty the queue of received frames
+#endif
+#ifndef MESSAGE_SEND_BLOCKING
+    tx_state = TX_IDLE;  // no frame being sent
+#endif
     tx_mask = eeprom_read_byte(EEPROM_TXMASK);  // read transmission mask from EEPROM
 
     // if transmission mask is outside of maximum value, then set it to the minimum value
@@ -159,6 +196,7 @@ void kilo_init() {
         kilo_irlow[i]=(eeprom_read_byte(EEPROM_IRLOW + i*2) <<8) | eeprom_read_byte(EEPROM_IRLOW + i*2+1);
         kilo_irhigh[i]=(eeprom_read_byte(EEPROM_IRHIGH + i*2) <<8) | eeprom_read_byte(EEPROM_IRHIGH + i*2+1);
     }
+    distance_lut_init();  // segments of the readings for estimate_distance()
 #endif
     sei();
 }
@@ -213,6 +251,38 @@ enum {
  */
 static volatile uint8_t prev_motion = MOVE_STOP, cur_motion = MOVE_STOP;
 
+#ifdef KILO_RX_DEFERRED
+/**
+ * @brief Queues the frame just received for kilo_message_rx (interrupt context)
+ *
+ * The frame is dropped when the queue is full.
+ *
+ */
+static inline void rx_enqueue() {
+    if (SPSC_full(rx_queue))
+        return;
+    SPSC_back(rx_queue).msg = rx_msg;
+    SPSC_back(rx_queue).dist = rx_dist;
+    SPSC_push(rx_queue);
+}
+
+/**
+ * @brief Hands every queued frame to kilo_message_rx, with interrupts enabled
+ *
+ */
+static void rx_dispatch() {
+    message_t msg;
+    distance_measurement_t dist;
+
+    while (!SPSC_empty(rx_queue)) {
+        msg = SPSC_front(rx_queue).msg;
+        dist = SPSC_front(rx_queue).dist;
+        SPSC_pop(rx_queue);  // copied out, so the interrupt may reuse the entry
+        kilo_message_rx(&msg, &dist);
+    }
+}
+#endif
+
 /**
  * @brief The main function for the kilobot, responsible for setting up the kilobot,
  * entering different states (e.g. sleeping, idle, charging, moving), and calling 
@@ -227,8 +297,12 @@ void kilo_start(void (*setup)(void), void (*loop)(void)) {
     int16_t voltage;
     uint8_t has_setup = 0;
     while (1) {
+#ifdef KILO_RX_DEFERRED
+        rx_dispatch();  // messages received since the last pass
+#endif
         switch (kilo_state) {
             case SLEEPING:
+                while (tx_busy());  // let the frame being sent end
                 cli();
                 acomp_off();
                 adc_off();
@@ -328,7 +402,11 @@ static inline void process_message() {
     AddressPointer_t reset = (AddressPointer_t)0x0000, bootload = (AddressPointer_t)0x7000;
     calibmsg_t *calibmsg = (calibmsg_t*)&rx_msg.data;
     if (rx_msg.type < BOOT) {
+#ifdef KILO_RX_DEFERRED
+        rx_enqueue();
+#else
         kilo_message_rx(&rx_msg, &rx_dist);
+#endif
         return;
     }
     if (rx_msg.type != READUID && rx_msg.type != RUN && rx_msg.type != CALIB)
@@ -458,11 +536,11 @@ void spinup_motors() {
 /**
  * @brief Gets the ambient light level by reading from the ADC
  * 
- * @return int16_t Ambient light level as measured by the ADC, or -1 if the receiver is currently busy 
+ * @return int16_t Ambient light level as measured by the ADC, or -1 if the receiver is currently busy or a frame is being sent
  */
 int16_t get_ambientlight() {
     int16_t light = -1;
-    if (!rx_busy) {
+    if (!rx_busy && !tx_busy()) {
         cli();
         adc_setup_conversion(7);
         adc_start_conversion();
@@ -477,11 +555,11 @@ int16_t get_ambientlight() {
 /**
  * @brief Gets the temperature by reading from the ADC
  * 
- * @return int16_t Temperature as measured by the ADC, or -1 if the receiver is currently busy
+ * @return int16_t Temperature as measured by the ADC, or -1 if the receiver is currently busy or a frame is being sent
  */
 int16_t get_temperature() {
     int16_t temp = -1;
-    if (!rx_busy) {
+    if (!rx_busy && !tx_busy()) {
         cli();
         ADMUX = (1<<3)|(1<<6)|(1<<7);
         ADCSRA = (1 << ADEN) | (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0);
@@ -507,6 +585,7 @@ uint8_t rand_hard() {
     for (i = 0; i < 8; i++) {
         tries = 0;
         do {
+            while (tx_busy());  // a conversion with interrupts off would delay the bits being sent
             cli();  // disable interrupts
 
             adc_setup_conversion(6);
@@ -560,11 +639,11 @@ void rand_seed(uint8_t s) {
  *
  * @details Reads the battery voltage using an analog-to-digital (AD) converter.
  * 
- * @return int16_t (The battery voltage in millivolts, or -1 if the RX module is busy)
+ * @return int16_t (The battery voltage in millivolts, or -1 if the RX module is busy or a frame is being sent)
  */
 int16_t get_voltage() {
     int16_t voltage = -1;
-    if (!rx_busy) {
+    if (!rx_busy && !tx_busy()) {
         cli();  // disable interrupts
 
         adc_setup_conversion(6);
@@ -578,76 +657,135 @@ int16_t get_voltage() {
     return voltage;
 }
 
+#ifndef MESSAGE_SEND_BLOCKING
 /**
- * @brief Estimate distance between two robots using IR distance measurements
- * 
- * This function estimates the distance between two robots using IR distance measurements.
- * It takes a pointer to a distance_measurement_t structure as input, which contains
- * the high and low gain IR distance measurements. It calculates the distance based on
- * the calibration values stored in the kilo_irlow and kilo_irhigh arrays.
+ * @brief Lights the IR led for one bit, as the irsend macro of message_send.S
  *
- * @param dist (Pointer to the distance_measurement_t structure containing IR distance measurements)
- * @return uint8_t (The estimated distance between two robots in millimeters)
  */
-uint8_t estimate_distance(const distance_measurement_t *dist) {
-    uint8_t i;
-    uint8_t index_high = 13;
-    uint8_t index_low = 255;
-    uint8_t dist_high = 255;
-    uint8_t dist_low = 255;
-
-    if (dist->high_gain < 900) {
-        if (dist->high_gain > kilo_irhigh[0]) {
-            dist_high = 0;
-        } else {
-            for (i = 1; i < 14; i++) {
-                if (dist->high_gain > kilo_irhigh[i]) {
-                    index_high = i;
-                    break;
-                }
-            }
+static inline void tx_pulse() {
+    uint8_t mask = tx_mask;
 
-            double slope = (kilo_irhigh[index_high]-kilo_irhigh[index_high-1])/0.5;
-            double b = (double)kilo_irhigh[index_high] - (double)slope*((double)index_high*(double)0.5 + (double)0.0);
-            b = (((((double)dist->high_gain-(double)b)*(double)10)));
-            b = ((int)((int)b/(int)slope));
-            dist_high = b;
-        }
+    tx_port |= mask;
+    __builtin_avr_delay_cycles(tx_pulse_cycles - 3);
+    tx_port &= ~mask;
+}
+
+/**
+ * @brief Ends the frame being sent and acts on its outcome (interrupt context)
+ *
+ * The outcome is what message_send() would have returned: the success
+ * callback and a new tx period when the frame went out, a random back-off
+ * when another sender was heard.
+ *
+ * @param sent (1 if the frame was sent, 0 if contention was detected)
+ */
+static void tx_done(uint8_t sent) {
+    rx_timer_off();
+    TIFR1 = (1 << OCF1A);  // passed rx_msgcycles while sending
+    TIMSK1 = (1 << OCIE1A);  // Timer1 times receptions again
+    //  only the led bits: the main loop may have changed the others (motors) meanwhile
+    tx_ddr = (tx_ddr & ~tx_mask) | (tx_saved_ddr & tx_mask);
+    tx_port &= ~tx_mask;
+    acomp_on();  // also forgets the echo of the last pulse
+    tx_state = TX_IDLE;
+
+    if (sent) {
+        kilo_message_tx_success();
+        tx_clock = 0;
+    } else {
+        //  timer0 has counted on since the interrupt that started the frame
+        tx_increment = rand()&0xFF;
+        if (tx_increment <= TCNT0)
+            tx_increment = TCNT0 + 1;
+        OCR0A = tx_increment;
     }
+}
 
-    if (dist->high_gain > 700) {
-        if (dist->low_gain > kilo_irlow[0]) {
-            dist_low = 0;
-        } else {
-            for (i = 1; i < 14; i++) {
-                if (dist->low_gain > kilo_irlow[i]) {
-                    index_low = i;
-                    break;
-                }
-            }
+/**
+ * @brief Starts sending a frame in the background (interrupt context)
+ *
+ * The start bit of the leading byte goes out right away, then
+ * ISR(TIMER1_COMPB_vect) listens for other senders and sends the rest,
+ * waking up only at the bits that light the led. The receiver is off until
+ * the frame ends, as in message_send(), and Timer1 is free since nothing
+ * is being received.
+ *
+ * @param msg (Message to send, copied)
+ */
+static void tx_start(const message_t *msg) {
+    tx_msg = *msg;
+    acomp_off();
+    tx_saved_ddr = tx_ddr;
+    tx_ddr |= tx_mask;
+
+    TIMSK1 = 0;  // no reception timeout while sending
+    TCNT1 = 0;
+    OCR1B = 2*rx_bitcycles;
+    TIFR1 = (1 << OCF1B);
+    TIMSK1 = (1 << OCIE1B);
+    TCCR1B = 1;
+    tx_pulse();
+    tx_state = TX_SENSE;
+}
 
-            if (index_low == 255) {
-                dist_low = 90;
-            } else {
-                double slope = (kilo_irlow[index_low]-kilo_irlow[index_low-1])/0.5;
-                double b = (double)kilo_irlow[index_low] - (double)slope*((double)index_low*(double)0.5 + (double)0.0);
-                b = (((((double)dist->low_gain-(double)b)*(double)10)));
-                b = ((int)((int)b/(int)slope));
-                dist_low = b;
+/**
+ * @brief Timer1 compare B interrupt: sends the next bit of the frame started by tx_start().
+ *
+ * @details Bits are 269 cycles apart, timed from the leading start bit, so
+ * the CPU runs the program between them. As in message_send(), the channel is
+ * sensed from two bits after the leading start bit until its stop bit: any
+ * pulse heard meanwhile (latched in ACI) or a carrier still present then
+ * means another sender, and the frame is abandoned.
+ *
+ * @return void
+ */
+ISR(TIMER1_COMPB_vect) {
+    uint16_t next = OCR1B + rx_bitcycles;
+
+    switch (tx_state) {
+        case TX_SENSE:
+            ACSR |= (1 << ACI);  // forget the echo of the start bit
+            next = OCR1B + 7*rx_bitcycles;
+            tx_state = TX_LISTEN;
+            break;
+        case TX_LISTEN:
+            if (ACSR & ((1 << ACI)|(1 << ACO))) {  //  Collision detected.
+                tx_done(0);
+                return;
             }
-        }
-    }
-
-    if (dist_low != 255) {
-        if (dist_high != 255) {
-            return 33 + ((double)dist_high*(900.0-dist->high_gain)+(double)dist_low*(dist->high_gain-700.0))/200.0;
-        } else {
-            return 33 + dist_low;
-        }
-    } else {
-        return 33 + dist_high;
+            tx_pulse();  // stop bit of the leading byte
+            tx_byteindex = 0;
+            tx_bitindex = 0;
+            tx_bytevalue = ((uint8_t*)&tx_msg)[0] << 1 | (1 << 0) | (1 << 9);
+            tx_state = TX_DATA;
+            break;
+        case TX_DATA:
+            tx_pulse();
+            //  on to the next bit set, the start bit of the next byte at the latest
+            while (1) {
+                tx_bytevalue >>= 1;
+                if (++tx_bitindex == 10) {
+                    if (++tx_byteindex == sizeof(message_t)) {
+                        tx_state = TX_LAST;  // one more bit for the echo to fade
+                        break;
+                    }
+                    tx_bitindex = 0;
+                    tx_bytevalue = ((uint8_t*)&tx_msg)[tx_byteindex] << 1 | (1 << 0) | (1 << 9);
+                }
+                if (tx_bytevalue & 1)
+                    break;
+                next += rx_bitcycles;
+            }
+            break;
+        case TX_LAST:
+            tx_done(1);
+            return;
+        default:
+            break;
     }
+    OCR1B = next;
 }
+#endif
 
 /**
  * Timer0 interrupt.
@@ -669,9 +807,10 @@ ISR(TIMER0_COMPA_vect) {
     OCR0A = tx_increment;
     kilo_ticks++;
 
-    if (!rx_busy && tx_clock > kilo_tx_period && kilo_state == RUNNING) {
+    if (!rx_busy && !tx_busy() && tx_clock > kilo_tx_period && kilo_state == RUNNING) {
         message_t *msg = kilo_message_tx();
         if (msg) {
+#ifdef MESSAGE_SEND_BLOCKING
             if (message_send(msg)) {
                 kilo_message_tx_success();
                 tx_clock = 0;
@@ -679,6 +818,9 @@ ISR(TIMER0_COMPA_vect) {
                 tx_increment = rand()&0xFF;
                 OCR0A = tx_increment;
             }
+#else
+            tx_start(msg);  // tx_done() follows once the frame is sent or gave way
+#endif
         }
     }
 }
@@ -50,6 +50,14 @@
 #define RGB(r,g,b) (r&3)|(((g&3)<<2))|((b&3)<<4)
 #define TICKS_PER_SEC 31
 
+// received frames held for kilo_message_rx with KILO_RX_DEFERRED (a power of two, at most 128), see kilo_message_rx
+#ifndef KILO_RX_QUEUE
+#define KILO_RX_QUEUE 4
+#endif
+#if KILO_RX_QUEUE & (KILO_RX_QUEUE - 1) || KILO_RX_QUEUE > 128
+#error "KILO_RX_QUEUE must be a power of two, at most 128"
+#endif
+
 /**
  * @brief Distance measurement.
  *
@@ -193,6 +201,15 @@ extern uint8_t kilo_straight_right;
  * @endcode
  *
  * @note You must register a message callback before calling kilo_start.
+ *
+ * @note The callback runs in the receive interrupt, so it should be short.
+ * Building kilolib with -DKILO_RX_DEFERRED (make KILO_FLAGS=-DKILO_RX_DEFERRED)
+ * moves it out: the interrupt only queues the frame and its distance
+ * measurement (up to KILO_RX_QUEUE frames; later ones are dropped until
+ * there is room), and kilo_start() calls the callback between two calls of
+ * loop(). The callback may then take its time, but frames received while
+ * loop() runs wait for it to return, and a program that spends seconds in
+ * delay() loses most of them.
  * @see message_t, message_crc, kilo_message_tx, kilo_message_tx_success
  */
 extern message_rx_t kilo_message_rx;
@@ -266,6 +283,14 @@ extern message_tx_t kilo_message_tx;
  * successful message callback is called when a message is transmitted
  * and no contention is detected on the channel.
  *
+ * @note Frames are sent by a timer interrupt, a bit at a time, while the
+ * program keeps running: the callback runs once the last bit is out,
+ * about 4 ms after ::kilo_message_tx returned the message, which is copied
+ * when the frame starts. Meanwhile no frame is received, and
+ * get_ambientlight(), get_temperature() and get_voltage() return -1.
+ * Building kilolib with -DMESSAGE_SEND_BLOCKING brings back message_send(),
+ * which sends the whole frame with interrupts disabled.
+ *
  * @see message_t, message_crc, kilo_message_tx, kilo_message_tx_success
  */
 extern message_tx_success_t kilo_message_tx_success;
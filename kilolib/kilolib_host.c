@@ -0,0 +1,400 @@
+/**
+ * @file kilolib_host.c
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Host (x86 Linux) backend of the kilolib API, driven by the simulator in sim/
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdlib.h>         // for RAND_MAX
+#include <string.h>         // for memcpy()
+
+#include "kilolib.h"
+#include "kilolib_host.h"
+
+/** Dummy functions to avoid null-pointer exceptions when accessing message reception and transmission functions. */
+void message_rx_dummy(message_t *m, distance_measurement_t *d) { }
+message_t *message_tx_dummy() { return NULL; }
+void message_tx_success_dummy() {}
+
+/** Function pointers to message reception and transmission functions. */
+message_rx_t kilo_message_rx = message_rx_dummy;
+message_tx_t kilo_message_tx = message_tx_dummy;
+message_tx_success_t kilo_message_tx_success = message_tx_success_dummy;
+
+volatile uint32_t kilo_ticks;      // internal clock (updated in tx ISR)
+volatile uint16_t kilo_tx_period;
+uint16_t kilo_uid;                 // unique identifier (stored in EEPROM)
+uint8_t kilo_turn_left;
+uint8_t kilo_turn_right;
+uint8_t kilo_straight_left;
+uint8_t kilo_straight_right;
+uint16_t kilo_irhigh[14];
+uint16_t kilo_irlow[14];
+
+/**
+ * @brief State of the robot whose code is currently running.
+ *
+ * Replaces the file-scope variables of kilolib.c (tx_clock, kilo_state, ...),
+ * which only exist once per process on the host.
+ */
+static kilo_host_cpu_t *cpu;
+
+/**
+ * @brief Enumeration of the possible states of the kilobot.
+ *
+ * Same values as kilolib.c; only SETUP and RUNNING are reachable on the host.
+ */
+enum {
+    SLEEPING,
+    IDLE,
+    BATTERY,
+    SETUP,
+    RUNNING,
+    CHARGING,
+    MOVING
+};
+
+void kilo_host_power_on(kilo_host_cpu_t *c) {
+    c->ticks = 0;
+    c->tx_period = 3906;
+    c->uid = 0;
+    c->message_rx = message_rx_dummy;
+    c->message_tx = message_tx_dummy;
+    c->message_tx_success = message_tx_success_dummy;
+    c->tx_clock = 0;
+    c->tx_increment = 255;
+    c->state = IDLE;
+    c->rx_busy = 0;
+    c->in_isr = 0;
+    c->rand_seed = 0xaa;
+    c->rand_accumulator = 0;
+    SPSC_init(c->rx_queue);
+    c->distance_lut.ready = 0;  // until kilo_init() reads the calibration
+}
+
+void kilo_host_switch_in(kilo_host_cpu_t *c) {
+    cpu = c;
+    kilo_ticks = c->ticks;
+    kilo_tx_period = c->tx_period;
+    kilo_uid = c->uid;
+    kilo_turn_left = c->turn_left;
+    kilo_turn_right = c->turn_right;
+    kilo_straight_left = c->straight_left;
+    kilo_straight_right = c->straight_right;
+    memcpy(kilo_irhigh, c->irhigh, sizeof(kilo_irhigh));
+    memcpy(kilo_irlow, c->irlow, sizeof(kilo_irlow));
+    kilo_distance_lut = c->distance_lut;
+    kilo_message_rx = c->message_rx;
+    kilo_message_tx = c->message_tx;
+    kilo_message_tx_success = c->message_tx_success;
+}
+
+void kilo_host_switch_out(kilo_host_cpu_t *c) {
+    c->ticks = kilo_ticks;
+    c->tx_period = kilo_tx_period;
+    c->uid = kilo_uid;
+    c->turn_left = kilo_turn_left;
+    c->turn_right = kilo_turn_right;
+    c->straight_left = kilo_straight_left;
+    c->straight_right = kilo_straight_right;
+    memcpy(c->irhigh, kilo_irhigh, sizeof(kilo_irhigh));
+    memcpy(c->irlow, kilo_irlow, sizeof(kilo_irlow));
+    c->distance_lut = kilo_distance_lut;
+    c->message_rx = kilo_message_rx;
+    c->message_tx = kilo_message_tx;
+    c->message_tx_success = kilo_message_tx_success;
+    cpu = NULL;
+}
+
+/**
+ * @brief Reads one byte of the current robot's EEPROM
+ *
+ * @param addr (EEPROM address, as in eeprom_map.h)
+ * @return uint8_t (Stored value)
+ */
+static uint8_t eeprom_read_byte(const uint8_t *addr) {
+    return cpu->eeprom[(uintptr_t)addr];
+}
+
+/**
+ * @brief Initializes the simulated kilobot
+ *
+ * Reads the calibration values from the robot's EEPROM image exactly as
+ * kilolib.c does and resets the transmission and clock state. There is no
+ * hardware to set up.
+ *
+ * @return void
+ */
+void kilo_init() {
+    cpu->rx_busy = 0;  // set reception flag to 0
+    cpu->in_isr = 0;
+    SPSC_init(cpu->rx_queue);  // empty the queue of received frames
+
+    cpu->tx_clock = 0;  // set transmission clock to 0
+    cpu->tx_increment = 255;  // set transmission increment to 255
+    kilo_ticks = 0;  // set kilobot ticks to 0
+    cpu->state = IDLE;  // set kilobot state to IDLE
+    kilo_tx_period = 3906;  // set kilobot transmission period to 3906
+
+    cpu->rand_seed = 0xaa;
+    cpu->rand_accumulator = 0;
+
+    // read UID values from EEPROM and merge the two bytes to create a 16-bit UID
+    kilo_uid = eeprom_read_byte(EEPROM_UID) | eeprom_read_byte(EEPROM_UID+1) << 8;
+
+    kilo_turn_left = eeprom_read_byte(EEPROM_LEFT_ROTATE);  // read left rotation value from EEPROM
+    kilo_turn_right = eeprom_read_byte(EEPROM_RIGHT_ROTATE);  // read right rotation value from EEPROM
+    kilo_straight_left = eeprom_read_byte(EEPROM_LEFT_STRAIGHT);  // read left straight value from EEPROM
+    kilo_straight_right = eeprom_read_byte(EEPROM_RIGHT_STRAIGHT);  // read right straight value from EEPROM
+
+    uint8_t i;
+    for (i = 0; i < 14; i++) {
+        kilo_irlow[i]=(eeprom_read_byte(EEPROM_IRLOW + i*2) <<8) | eeprom_read_byte(EEPROM_IRLOW + i*2+1);
+        kilo_irhigh[i]=(eeprom_read_byte(EEPROM_IRHIGH + i*2) <<8) | eeprom_read_byte(EEPROM_IRHIGH + i*2+1);
+    }
+    distance_lut_init();  // segments of the readings for estimate_distance()
+}
+
+/**
+ * @brief Hands a frame to kilo_message_rx, unless it is a system message
+ *
+ * @param f (Frame, taken off the queue)
+ */
+static void rx_deliver(kilo_host_frame_t *f) {
+    if (f->msg.type < BOOT) {
+        kilo_host_rx_delivered(f->sender, &f->dist);
+        kilo_message_rx(&f->msg, &f->dist);
+    }
+}
+
+#ifdef KILO_RX_DEFERRED
+/**
+ * @brief Hands every queued frame to kilo_message_rx, as kilo_start() does in kilolib.c
+ *
+ */
+static void rx_dispatch() {
+    kilo_host_frame_t f;
+
+    while (!SPSC_empty(cpu->rx_queue)) {
+        f = SPSC_front(cpu->rx_queue);
+        SPSC_pop(cpu->rx_queue);
+        rx_deliver(&f);
+    }
+}
+#endif
+
+/**
+ * @brief Runs the user program of the simulated kilobot.
+ *
+ * On the kilobot the overhead controller moves the robot from IDLE to SETUP
+ * with a RUN message; the simulator plays that role by starting every robot
+ * straight away. Between two loop() calls the robot sleeps until its next
+ * interrupt, since nothing it can observe changes before then; with
+ * KILO_RX_DEFERRED it hands the frames received meanwhile to
+ * kilo_message_rx instead, if there are any.
+ *
+ * @param setup (A pointer to the user-defined setup function)
+ * @param loop (A pointer to the user-defined loop function)
+ *
+ * @return void
+ */
+void kilo_start(void (*setup)(void), void (*loop)(void)) {
+    cpu->state = SETUP;
+    setup();
+    cpu->state = RUNNING;
+    while (1) {
+        loop();
+#ifdef KILO_RX_DEFERRED
+        if (SPSC_empty(cpu->rx_queue))
+            kilo_host_idle();
+        rx_dispatch();
+#else
+        kilo_host_idle();
+#endif
+    }
+}
+
+uint8_t kilo_host_rx_push(kilo_host_cpu_t *c, const message_t *msg, const distance_measurement_t *dist, int32_t sender) {
+    if (SPSC_full(c->rx_queue))
+        return 0;
+    SPSC_back(c->rx_queue).msg = *msg;
+    SPSC_back(c->rx_queue).dist = *dist;
+    SPSC_back(c->rx_queue).sender = sender;
+    SPSC_push(c->rx_queue);
+    return 1;
+}
+
+void kilo_host_rx_isr(void) {
+    kilo_host_frame_t f = SPSC_front(cpu->rx_queue);
+
+    SPSC_pop(cpu->rx_queue);
+    cpu->in_isr = 1;
+    rx_deliver(&f);
+    cpu->in_isr = 0;
+}
+
+void kilo_host_timer_isr(void) {
+    cpu->in_isr = 1;
+    cpu->tx_clock += cpu->tx_increment;
+    cpu->tx_increment = 0xFF;
+    kilo_ticks++;
+
+    if (!cpu->rx_busy && cpu->tx_clock > kilo_tx_period && cpu->state == RUNNING) {
+        message_t *msg = kilo_message_tx();
+        if (msg) {
+            if (kilo_host_message_send(msg)) {
+                kilo_message_tx_success();
+                cpu->tx_clock = 0;
+            } else {
+                cpu->tx_increment = rand()&0xFF;
+            }
+        }
+    }
+    cpu->in_isr = 0;
+}
+
+uint32_t kilo_host_timer_quiet(void) {
+    uint32_t clock = (uint32_t)cpu->tx_clock + cpu->tx_increment;
+
+    if (cpu->state != RUNNING)
+        return UINT32_MAX;
+    if (clock > kilo_tx_period)
+        return 0;
+    return (kilo_tx_period - clock) / 0xFF + 1;
+}
+
+void kilo_host_timer_skip(uint32_t n) {
+    cpu->tx_clock += cpu->tx_increment + 0xFF*(n - 1);
+    cpu->tx_increment = 0xFF;
+    kilo_ticks += n;
+}
+
+/**
+ * @brief Delays for the specified number of milliseconds
+ *
+ * @param ms (Number of milliseconds to delay)
+ */
+void delay(uint16_t ms) {
+    kilo_host_wait((kilo_cycles_t)ms*KILO_CYCLES_PER_MS);
+}
+
+/**
+ * @brief Sets the motors to the specified duty cycle
+ *
+ * @param ccw (Duty cycle for the counterclockwise motor)
+ * @param cw (Duty cycle for the clockwise motor)
+ */
+void set_motors(uint8_t ccw, uint8_t cw) {
+    kilo_host_set_motors(ccw, cw);
+}
+
+/**
+ * @brief Spins up the motors by setting both to 100% duty cycle for 15 ms
+ *
+ */
+void spinup_motors() {
+    set_motors(255, 255);
+    delay(15);
+}
+
+/**
+ * @brief Gets the ambient light level
+ *
+ * @return int16_t Ambient light level, or -1 if the receiver is currently busy
+ */
+int16_t get_ambientlight() {
+    int16_t light = -1;
+    if (!cpu->rx_busy)
+        light = kilo_host_adc_read(7);
+    return light;
+}
+
+/**
+ * @brief Gets the temperature
+ *
+ * @return int16_t Temperature, or -1 if the receiver is currently busy
+ */
+int16_t get_temperature() {
+    int16_t temp = -1;
+    if (!cpu->rx_busy)
+        temp = kilo_host_adc_read(8);
+    return temp;
+}
+
+/**
+ * @brief Reads the battery voltage
+ *
+ * @return int16_t (The battery voltage, or -1 if the RX module is busy)
+ */
+int16_t get_voltage() {
+    int16_t voltage = -1;
+    if (!cpu->rx_busy)
+        voltage = kilo_host_adc_read(6);
+    return voltage;
+}
+
+/**
+ * @brief Generates a random number using the simulator's entropy source
+ *
+ * @return uint8_t (The generated random number)
+ */
+uint8_t rand_hard() {
+    return kilo_host_random(KILO_RNG_HARD) & 0xFF;
+}
+
+/**
+ * @brief Generates a random number using software-based randomization
+ *
+ * @details Same generator as kilolib.c, with its state kept per robot.
+ *
+ * @return The generated random number
+ */
+uint8_t rand_soft() {
+    cpu->rand_seed ^= cpu->rand_seed << 3;
+    cpu->rand_seed ^= cpu->rand_seed >> 5;
+    cpu->rand_seed ^= cpu->rand_accumulator++>>2;
+    return cpu->rand_seed;
+}
+
+/**
+ * @brief Seeds the software-based random number generator.
+ *
+ * @param s (The seed value)
+ */
+void rand_seed(uint8_t s) {
+    cpu->rand_seed = s;
+}
+
+/**
+ * @brief libc's rand(), replaced so that every robot draws from its own stream
+ *
+ * @return int (Random number between 0 and RAND_MAX)
+ */
+int rand(void) {
+    return kilo_host_random(KILO_RNG_LIBC) & RAND_MAX;
+}
+
+/**
+ * @brief libc's srand(), replaced to restart the current robot's rand() stream
+ *
+ * @param seed (Selects the sequence)
+ */
+void srand(unsigned int seed) {
+    kilo_host_random_seed(KILO_RNG_LIBC, seed);
+}
+
+/**
+ * @brief Set LED color.
+ *
+ * @param rgb The packed RGB value.
+ *
+ * @return void
+ */
+void set_color(uint8_t rgb) {
+    kilo_host_set_color(rgb);
+}
@@ -0,0 +1,270 @@
+/**
+ * @file kilolib_host.h
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Interface between the host (x86 Linux) kilolib backend and the simulator driving it.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef __KILOLIB_HOST_H__
+#define __KILOLIB_HOST_H__
+
+/**
+ * @file kilolib_host.h
+ *
+ * The host backend (kilolib_host.c) implements the kilolib.h API for
+ * programs compiled with gcc for the simulator. Everything that touches
+ * hardware on the kilobot (motors, led, IR transmitter, ADC, the passage of
+ * time) is forwarded to a set of kilo_host_*() hooks that the simulator
+ * implements.
+ *
+ * The backend keeps the state of one robot at a time in the usual kilolib
+ * globals (kilo_ticks, kilo_uid, kilo_message_rx, ...). The simulator owns one
+ * ::kilo_host_cpu_t per robot and swaps it in with kilo_host_switch_in() before
+ * running any code of that robot, and out with kilo_host_switch_out() after.
+ *
+ * Time is counted in cycles of the 8 MHz ATmega328P, so that delays, timer0
+ * compare matches and IR bit periods share one exact unit.
+ */
+
+#include <stdint.h>
+#include "kilolib.h"
+#include "eeprom_map.h"
+#include "distance.h"
+#include "ringbuffer_spsc.h"
+
+#define KILO_F_CPU          8000000UL                 // kilobot clock frequency (Hz)
+#define KILO_CYCLES_PER_MS  (KILO_F_CPU/1000)          // cycles in one millisecond
+#define KILO_TIMER0_PRESCALE 1024                      // timer0 prescaler set by tx_timer_setup()
+#define KILO_TICK_CYCLES    (256UL*KILO_TIMER0_PRESCALE)  // cycles in one timer0 period (one kilo_tick)
+
+#define KILO_RNG_HARD        0  // random stream of rand_hard()
+#define KILO_RNG_LIBC        1  // random stream of rand(), e.g. the tx backoff of the timer0 ISR
+#define KILO_RNG_SENSOR      2  // random stream of the sensor noise
+#define KILO_RNG_STREAMS     3  // random streams of each robot
+
+typedef uint64_t kilo_cycles_t;  //  Simulated time, in CPU cycles.
+
+//  1 if the receive interrupt hands frames to kilo_message_rx, 0 if kilo_start() does
+#ifdef KILO_RX_DEFERRED
+#define KILO_HOST_RX_IN_ISR 0
+#else
+#define KILO_HOST_RX_IN_ISR 1
+#endif
+
+/**
+ * @brief A frame heard by a robot and not yet handed to its kilo_message_rx.
+ */
+typedef struct {
+    message_t msg;                      //  received message
+    distance_measurement_t dist;        //  signal strength measured while receiving it
+    int32_t sender;                     //  sending robot, for the simulator's statistics
+} kilo_host_frame_t;
+
+/**
+ * @brief Per-robot state of the host kilolib backend.
+ *
+ * The first block mirrors the public kilolib globals, the second block
+ * mirrors the file-scope state of kilolib.c.
+ */
+typedef struct {
+    uint32_t ticks;                     //  kilo_ticks
+    uint16_t tx_period;                 //  kilo_tx_period
+    uint16_t uid;                       //  kilo_uid
+    uint8_t turn_left;                  //  kilo_turn_left
+    uint8_t turn_right;                 //  kilo_turn_right
+    uint8_t straight_left;              //  kilo_straight_left
+    uint8_t straight_right;             //  kilo_straight_right
+    uint16_t irhigh[14];                //  kilo_irhigh
+    uint16_t irlow[14];                 //  kilo_irlow
+    distance_lut_t distance_lut;        //  kilo_distance_lut
+    message_rx_t message_rx;            //  kilo_message_rx
+    message_tx_t message_tx;            //  kilo_message_tx
+    message_tx_success_t message_tx_success;  //  kilo_message_tx_success
+
+    uint16_t tx_clock;                  //  number of timer cycles we have waited
+    uint16_t tx_increment;              //  number of timer cycles until next interrupt (OCR0A)
+    uint8_t state;                      //  kilo_state
+    uint8_t rx_busy;                    //  set by the simulator while a frame is being received
+    uint8_t in_isr;                     //  set while an interrupt handler is running
+    uint8_t rand_seed;                  //  rand_soft() state
+    uint8_t rand_accumulator;           //  rand_soft() state
+    SPSC_type(kilo_host_frame_t, KILO_RX_QUEUE) rx_queue;  //  frames waiting for kilo_message_rx, see kilo_host_rx_push()
+    uint8_t eeprom[EEPROM_SIZE];        //  contents of the robot's EEPROM
+} kilo_host_cpu_t;
+
+#ifdef __cplusplus /* If this is a C++ compiler, use C linkage */
+extern "C" {
+#endif
+
+/* ---- provided by the host backend, called by the simulator ---- */
+
+/**
+ * @brief Put @p cpu in its power-on state, keeping the EEPROM contents.
+ *
+ * @param cpu (State of the robot being powered on)
+ */
+void kilo_host_power_on(kilo_host_cpu_t *cpu);
+
+/**
+ * @brief Make @p cpu the robot whose state is held in the kilolib globals.
+ *
+ * @param cpu (State of the robot about to run)
+ */
+void kilo_host_switch_in(kilo_host_cpu_t *cpu);
+
+/**
+ * @brief Save the kilolib globals back into @p cpu.
+ *
+ * @param cpu (State of the robot that just ran)
+ */
+void kilo_host_switch_out(kilo_host_cpu_t *cpu);
+
+/**
+ * @brief Body of ISR(TIMER0_COMPA_vect) for the current robot.
+ *
+ * Counts one tick and, when the tx period has elapsed, asks the program
+ * for a message and hands it to kilo_host_message_send(). On return
+ * `tx_increment` holds the new OCR0A value.
+ */
+void kilo_host_timer_isr(void);
+
+/**
+ * @brief Number of upcoming timer0 interrupts of the current robot that cannot transmit.
+ *
+ * Those interrupts only count ticks and advance the tx clock, so the
+ * simulator may apply them in one go with kilo_host_timer_skip() instead of
+ * running them one by one. The first of them adds `tx_increment` to the tx
+ * clock, the following ones 255 each.
+ *
+ * @return uint32_t (Number of interrupts, UINT32_MAX if the robot is not running its program)
+ */
+uint32_t kilo_host_timer_quiet(void);
+
+/**
+ * @brief Apply @p n timer0 interrupts that kilo_host_timer_quiet() counted as unable to transmit.
+ *
+ * @param n (Number of interrupts, at least 1)
+ */
+void kilo_host_timer_skip(uint32_t n);
+
+/**
+ * @brief Queue a frame with a valid CRC that a robot has just heard.
+ *
+ * The only place a robot drops frames: they wait in its rx_queue, for the
+ * receive interrupt (kilo_host_rx_isr()) or, with KILO_RX_DEFERRED, for
+ * kilo_start(), and are dropped when KILO_RX_QUEUE frames already wait.
+ * The robot need not be the current one.
+ *
+ * @param c (State of the receiving robot)
+ * @param msg (Received message)
+ * @param dist (Signal strength measured while receiving it)
+ * @param sender (Sending robot, passed back to kilo_host_rx_delivered())
+ * @return uint8_t (1 if the frame was queued, 0 if it was dropped)
+ */
+uint8_t kilo_host_rx_push(kilo_host_cpu_t *c, const message_t *msg, const distance_measurement_t *dist, int32_t sender);
+
+/**
+ * @brief Run the receive interrupt of the current robot for its oldest queued frame.
+ *
+ * This is the host counterpart of process_message() in kilolib.c: the frame
+ * is handed to kilo_message_rx. Only called when KILO_HOST_RX_IN_ISR is 1 and
+ * a frame is queued.
+ */
+void kilo_host_rx_isr(void);
+
+/* ---- provided by the simulator, called by the host backend ---- */
+
+/**
+ * @brief Suspend the current robot for @p cycles, servicing its interrupts meanwhile.
+ *
+ * @param cycles (Number of CPU cycles to wait)
+ */
+void kilo_host_wait(kilo_cycles_t cycles);
+
+/**
+ * @brief Suspend the current robot until it has serviced at least one interrupt.
+ *
+ * Called by kilo_start() between two loop() calls: nothing a program can
+ * observe changes until an interrupt runs. With KILO_RX_DEFERRED it also
+ * returns once a frame is queued for kilo_start().
+ */
+void kilo_host_idle(void);
+
+/**
+ * @brief Account for a frame handed to the current robot's kilo_message_rx, just before it is.
+ *
+ * @param sender (Sending robot, as given to kilo_host_rx_push())
+ * @param dist (Signal strength measured while receiving it)
+ */
+void kilo_host_rx_delivered(int32_t sender, const distance_measurement_t *dist);
+
+/**
+ * @brief Apply a new motor duty-cycle pair to the current robot.
+ *
+ * @param left (Left motor duty cycle)
+ * @param right (Right motor duty cycle)
+ */
+void kilo_host_set_motors(uint8_t left, uint8_t right);
+
+/**
+ * @brief Apply a new led color to the current robot.
+ *
+ * @param color (Packed RGB value)
+ */
+void kilo_host_set_color(uint8_t color);
+
+/**
+ * @brief Transmit a message from the current robot.
+ *
+ * @param msg (Message to transmit)
+ * @return uint8_t (1 if it was sent, 0 if contention was detected, as message_send())
+ */
+uint8_t kilo_host_message_send(const message_t *msg);
+
+/**
+ * @brief Perform an ADC conversion for the current robot.
+ *
+ * @param channel (ADMUX channel: 6 battery voltage, 7 ambient light, 8 temperature)
+ * @return int16_t (10-bit conversion result)
+ */
+int16_t kilo_host_adc_read(uint8_t channel);
+
+/**
+ * @brief Next number of one of the current robot's random streams.
+ *
+ * Each draw depends only on the run seed, the branch of the run (see the
+ * simulator's world_fork()), the robot, the stream and the number of
+ * earlier draws from that stream, so runs replay identically
+ * whatever the other robots draw and however many threads simulate them.
+ *
+ * @param stream (KILO_RNG_HARD, KILO_RNG_LIBC or KILO_RNG_SENSOR)
+ * @return uint32_t (32 random bits)
+ */
+uint32_t kilo_host_random(uint8_t stream);
+
+/**
+ * @brief Restart one of the current robot's random streams with another sequence, as srand() does.
+ *
+ * @param stream (KILO_RNG_HARD, KILO_RNG_LIBC or KILO_RNG_SENSOR)
+ * @param seed (Selects the sequence)
+ */
+void kilo_host_random_seed(uint8_t stream, uint32_t seed);
+
+/**
+ * @brief printf() replacement used by debug.h in the host build.
+ *
+ * @param fmt (printf format string)
+ * @return int (Number of characters written, or 0 when the output is silenced)
+ */
+int kilo_host_printf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+#ifdef __cplusplus /* If this is a C++ compiler, use C linkage */
+}
+#endif
+
+#endif//__KILOLIB_HOST_H__
@@ -14,8 +14,9 @@
 #define __MESSAGE_BUFFERED_H__
 
 #include "kilolib.h"
-#include "ringbuffer.h"
+#include "ringbuffer_spsc.h"
 
+// sizes of the buffers, powers of two up to 128
 #ifndef RXBUFFER_SIZE
 #define RXBUFFER_SIZE 16
 #endif
@@ -32,8 +33,8 @@ typedef struct {
     distance_measurement_t dist;  //  Distance measurement.
 } received_message_t;
 
-RB_create(rxbuffer, received_message_t, RXBUFFER_SIZE);  //  Ring buffer for received messages and distance measurements
-RB_create(txbuffer, message_t, TXBUFFER_SIZE);  //  Ring buffer for transmitted messages
+SPSC_create(rxbuffer, received_message_t, RXBUFFER_SIZE);  //  Received messages and distance measurements, from kilo_message_rx to loop()
+SPSC_create(txbuffer, message_t, TXBUFFER_SIZE);  //  Messages to transmit, from loop() to the transmit interrupt
 
 /**
  * @brief Returns the current size of the receive buffer.
@@ -41,20 +42,26 @@ RB_create(txbuffer, message_t, TXBUFFER_SIZE);  //  Ring buffer for transmitted
  * @return uint8_t (The size of the receive buffer.)
  */
 uint8_t rxbuffer_size() {
-    return RB_size(rxbuffer);
+    return SPSC_size(rxbuffer);
 }
 
 /**
  * @brief Adds a received message and distance measurement to the receive buffer
+ *
+ * The message is dropped when the buffer is full.
  * 
  * @param msg (Pointer to the received message)
  * @param dist (Pointer to the distance measurement)
  */
 void rxbuffer_push(message_t *msg, distance_measurement_t *dist) {
-    received_message_t *rmsg = &RB_back(rxbuffer);
+    received_message_t *rmsg;
+
+    if (SPSC_full(rxbuffer))
+        return;
+    rmsg = &SPSC_back(rxbuffer);
     rmsg->msg = *msg;
     rmsg->dist = *dist;
-    RB_pushback(rxbuffer);
+    SPSC_push(rxbuffer);
 }
 
 /**
@@ -64,10 +71,10 @@ void rxbuffer_push(message_t *msg, distance_measurement_t *dist) {
  * @return message_t* (Pointer to the next received message, or NULL if the buffer is empty)
  */
 message_t *rxbuffer_peek(distance_measurement_t *dist) {
-    if (RB_empty(rxbuffer))
+    if (SPSC_empty(rxbuffer))
         return '\0';
     else {
-        received_message_t *rmsg = &RB_front(rxbuffer);
+        received_message_t *rmsg = &SPSC_front(rxbuffer);
         *dist = rmsg->dist;
         return &rmsg->msg;
     }
@@ -78,8 +85,8 @@ message_t *rxbuffer_peek(distance_measurement_t *dist) {
  * 
  */
 void rxbuffer_pop() {
-    if (!RB_empty(rxbuffer)) {
-        RB_popfront(rxbuffer);
+    if (!SPSC_empty(rxbuffer)) {
+        SPSC_pop(rxbuffer);
     }
 }
 
@@ -89,17 +96,24 @@ void rxbuffer_pop() {
  * @return uint8_t (The size of the transmit buffer)
  */
 uint8_t txbuffer_size() {
-    return RB_size(txbuffer);
+    return SPSC_size(txbuffer);
 }
 
 /**
  * @brief Adds a message to the transmit buffer.
+ *
+ * The message is not added when the buffer is full: the oldest one may be
+ * on its way out in the transmit interrupt, so it cannot be overwritten.
  * 
  * @param msg (Pointer to the message to transmit)
+ * @return uint8_t (1 if the message was added, 0 if the buffer is full)
  */
-void txbuffer_push(message_t *msg) {
-    RB_back(txbuffer) = *msg;
-    RB_pushback(txbuffer);
+uint8_t txbuffer_push(message_t *msg) {
+    if (SPSC_full(txbuffer))
+        return 0;
+    SPSC_back(txbuffer) = *msg;
+    SPSC_push(txbuffer);
+    return 1;
 }
 
 /**
@@ -108,10 +122,10 @@ void txbuffer_push(message_t *msg) {
  * @return message_t* (Pointer to the next message to transmit, or NULL if the buffer is empty)
  */
 message_t *txbuffer_peek() {
-    if (RB_empty(txbuffer))
+    if (SPSC_empty(txbuffer))
         return '\0';
     else
-        return &RB_front(txbuffer);
+        return &SPSC_front(txbuffer);
 }
 
 /**
@@ -119,8 +133,8 @@ message_t *txbuffer_peek() {
  * 
  */
 void txbuffer_pop() {
-    if (!RB_empty(txbuffer))
-        RB_popfront(txbuffer);
+    if (!SPSC_empty(txbuffer))
+        SPSC_pop(txbuffer);
 }
 
 /**
@@ -128,8 +142,8 @@ void txbuffer_pop() {
  * 
  */
 inline void kilo_message_buffered() {
-    RB_init(rxbuffer);
-    RB_init(txbuffer);
+    SPSC_init(rxbuffer);
+    SPSC_init(txbuffer);
     kilo_message_rx = rxbuffer_push;
     kilo_message_tx = txbuffer_peek;
     kilo_message_tx_success = txbuffer_pop;
@@ -11,7 +11,23 @@
  */
 
 #include "message.h"
+
+#ifndef SIMULATOR
 #include <util/crc16.h>  // for optimized crc routines
+#else
+/**
+ * @brief Portable equivalent of avr-libc's _crc_ccitt_update() for the host build
+ *
+ * @param crc (Running CRC value)
+ * @param data (Next byte of the message)
+ * @return uint16_t (Updated CRC value)
+ */
+static inline uint16_t _crc_ccitt_update(uint16_t crc, uint8_t data) {
+    data ^= crc&0xFF;
+    data ^= data << 4;
+    return ((((uint16_t)data << 8) | (crc >> 8)) ^ (uint8_t)(data >> 4) ^ ((uint16_t)data << 3));
+}
+#endif
 
 /**
  * @brief Calculates the CRC-16 value for the given message 
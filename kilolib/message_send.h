@@ -30,6 +30,9 @@ extern volatile uint8_t tx_mask;
  * 
  * This function sends a message using the message_t structure provided as an argument.
  * It returns a uint8_t value indicating whether the send was successful or not.
+ * Interrupts are disabled until the whole frame is sent (about 4 ms). kilolib
+ * itself only uses it when built with -DMESSAGE_SEND_BLOCKING; otherwise
+ * ISR(TIMER1_COMPB_vect) in kilolib.c sends its frames in the background.
  *
  * @param message (A pointer to a message_t structure containing the message to send)
  *
@@ -1,3 +1,6 @@
+// Kept for programs that use it. kilolib itself uses ringbuffer_spsc.h, which
+// needs no division and is safe between an interrupt and the main loop.
+
 #ifndef __RINGBUFFER_H__
 #define __RINGBUFFER_H__
 
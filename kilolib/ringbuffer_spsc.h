@@ -0,0 +1,104 @@
+/**
+ * @file ringbuffer_spsc.h
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Ring buffer for handing elements from an interrupt to the main loop, or back, without disabling interrupts
+ *
+ * One side only pushes (the producer) and the other only pops (the
+ * consumer), for instance the receive interrupt and kilo_start(). The
+ * producer only writes head, after filling the element it points to; the
+ * consumer only writes tail, after it is done with the element it points
+ * to. Both are 8-bit, so each is read and written in one instruction, and
+ * count freely modulo 256: the buffer holds head - tail elements, and an
+ * element is found by masking, since the capacity is a power of two (at
+ * most 128). Nothing is divided, unlike ringbuffer.h.
+ *
+ * A full buffer refuses a push rather than dropping its oldest element,
+ * which would have the producer write tail too.
+ *
+ * Producer:
+ *     if (!SPSC_full(buf)) {
+ *         SPSC_back(buf) = x;
+ *         SPSC_push(buf);
+ *     }
+ * Consumer:
+ *     if (!SPSC_empty(buf)) {
+ *         x = SPSC_front(buf);
+ *         SPSC_pop(buf);
+ *     }
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef __RINGBUFFER_SPSC_H__
+#define __RINGBUFFER_SPSC_H__
+
+#include <stdint.h>
+
+//  accesses to the elements stay after the other side's index is read (acquire)
+//  and before this side's index is written (release); on the AVR a compiler barrier
+#ifdef __AVR__
+#define SPSC_acquire() __asm__ __volatile__("" ::: "memory")
+#define SPSC_release() __asm__ __volatile__("" ::: "memory")
+#else
+#define SPSC_acquire() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define SPSC_release() __atomic_thread_fence(__ATOMIC_RELEASE)
+#endif
+
+//  type of a buffer of SIZE elements of type T, for a member of a structure
+#define SPSC_type(T, SIZE)\
+    struct {\
+        volatile uint8_t head;\
+        volatile uint8_t tail;\
+        T elems[SIZE];\
+    }
+
+//  declares buffer NAME, failing to compile unless SIZE is a power of two, at most 128
+#define SPSC_create(NAME, T, SIZE)\
+    SPSC_type(T, SIZE) NAME;\
+    typedef char NAME##_spsc_size_is_a_power_of_two[((SIZE) & ((SIZE) - 1)) == 0 && (SIZE) <= 128 ? 1 : -1]
+
+#define SPSC_init(o) {\
+    (o).head = 0;\
+    (o).tail = 0;\
+}
+
+#define SPSC_capacity(o) ((uint8_t)(sizeof((o).elems) / sizeof((o).elems[0])))
+
+#define SPSC_mask(o) (SPSC_capacity(o) - 1)
+
+//  elements held, seen from either side
+#define SPSC_size(o) ({\
+    uint8_t spsc_size = (o).head - (o).tail;\
+    SPSC_acquire();\
+    spsc_size;\
+})
+
+#define SPSC_empty(o) (SPSC_size(o) == 0)
+
+#define SPSC_full(o) (SPSC_size(o) == SPSC_capacity(o))
+
+//  element the next push makes visible (producer, when not full)
+#define SPSC_back(o) (o).elems[(o).head & SPSC_mask(o)]
+
+//  oldest element (consumer, when not empty)
+#define SPSC_front(o) (o).elems[(o).tail & SPSC_mask(o)]
+
+//  element i (0 to SPSC_size(o) - 1) from the front (consumer)
+#define SPSC_idx(o, i) (o).elems[(uint8_t)((o).tail + (i)) & SPSC_mask(o)]
+
+#define SPSC_push(o) {\
+    SPSC_release();\
+    (o).head = (o).head + 1;\
+}
+
+#define SPSC_pop(o) {\
+    SPSC_release();\
+    (o).tail = (o).tail + 1;\
+}
+
+#endif//__RINGBUFFER_SPSC_H__
@@ -0,0 +1,265 @@
+/**
+ * @file analyze.c
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Formation metrics of traced simulation runs (see trace.h), one line per run
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "../kilolib/kilolib_host.h"
+#include "pool.h"
+#include "trace.h"
+
+#define DEFAULT_IN_FIRST_CIRCLE 2     // ROBOTS_IN_FIRST_CIRCLE of singles_circle1.c
+#define DEFAULT_DISTANCE        55.0  // DESIRED_DISTANCE of singles_circle1.c (mm)
+#define DEFAULT_EPSILON         15.0  // EPSILON of singles_circle1.c (mm)
+
+/**
+ * @brief What counts as the first circle around the seed.
+ */
+typedef struct {
+    int in_first_circle;    //  robots the circle needs to be formed
+    double distance;        //  radius of the circle (mm)
+    double epsilon;         //  tolerance on the radius (mm)
+    int seed;               //  kilo_uid of the seed
+} analyze_config_t;
+
+/**
+ * @brief The ring at one tick: robots within distance ± epsilon of the seed.
+ */
+typedef struct {
+    uint32_t in_ring;       //  robots in the ring
+    uint32_t moving;        //  robots with a motor on
+    double radius_var;      //  variance of their distances to the seed (mm^2), NAN with fewer than two
+    double spacing_cv;      //  coefficient of variation of the angular gaps between them, NAN with fewer than two
+} analyze_tick_t;
+
+/**
+ * @brief Work shared by the tasks of one trace, one task per chunk.
+ */
+typedef struct {
+    const trace_view_t *v;
+    const analyze_config_t *config;
+    analyze_tick_t *ticks;                  //  one per tick
+    uint64_t (*status)[TRACE_BAD_CRC + 1];  //  events of each chunk by status
+    double **angles;                        //  scratch of each worker, one angle per robot
+} analyze_t;
+
+/**
+ * @brief Orders angles
+ *
+ * @param a (Angle)
+ * @param b (Angle)
+ * @return int (qsort() comparison)
+ */
+static int compare_angles(const void *a, const void *b) {
+    double p = *(const double *)a, q = *(const double *)b;
+    return (p > q) - (p < q);
+}
+
+/**
+ * @brief Measures the ring at one tick
+ *
+ * @param a (Analysis)
+ * @param tick (Tick)
+ * @param angles (Scratch, one entry per robot)
+ * @param out (Receives the ring)
+ */
+static void analyze_tick(const analyze_t *a, uint32_t tick, double *angles, analyze_tick_t *out) {
+    const trace_view_t *v = a->v;
+    const float *x = trace_row(v, tick, TRACE_X), *y = trace_row(v, tick, TRACE_Y);
+    const uint8_t *left = trace_row(v, tick, TRACE_MOTOR_LEFT), *right = trace_row(v, tick, TRACE_MOTOR_RIGHT);
+    double sx = x[a->config->seed], sy = y[a->config->seed], sum = 0, sum2 = 0, mean, gap, gsum2 = 0;
+    uint32_t n = 0, i;
+
+    out->moving = 0;
+    for (i = 0; i < v->header->robots; i++)
+        out->moving += (left[i] | right[i]) != 0;
+    for (i = 0; i < v->header->robots; i++) {
+        double dx = x[i] - sx, dy = y[i] - sy, d = sqrt(dx*dx + dy*dy);
+        if (i == (uint32_t)a->config->seed || fabs(d - a->config->distance) > a->config->epsilon)
+            continue;
+        angles[n++] = atan2(dy, dx);
+        sum += d;
+        sum2 += d*d;
+    }
+    out->in_ring = n;
+    out->radius_var = out->spacing_cv = NAN;
+    if (n < 2)
+        return;
+    mean = sum / n;
+    out->radius_var = sum2 / n - mean*mean;
+    //  gaps between neighbours around the seed; all equal to 2 pi / n in a perfect ring
+    qsort(angles, n, sizeof(double), compare_angles);
+    for (i = 0; i < n; i++) {
+        gap = (i + 1 < n ? angles[i + 1] : angles[0] + 2*M_PI) - angles[i];
+        gsum2 += gap*gap;
+    }
+    mean = 2*M_PI / n;
+    out->spacing_cv = sqrt(fmax(gsum2 / n - mean*mean, 0)) / mean;
+}
+
+/**
+ * @brief Task: measures the ring at every tick of a chunk and counts its events
+ *
+ * @param arg (Analysis)
+ * @param task (Chunk)
+ * @param worker (Worker running the task)
+ */
+static void analyze_chunk(void *arg, int task, int worker) {
+    analyze_t *a = arg;
+    const trace_chunk_t *c = trace_chunk(a->v, task);
+    uint64_t e, end = c->event_first + c->event_count;
+    uint32_t k;
+
+    for (k = 0; k < c->ticks; k++)
+        analyze_tick(a, c->first_tick + k, a->angles[worker], &a->ticks[c->first_tick + k]);
+    if (end > a->v->events_n)
+        end = a->v->events_n;
+    for (e = c->event_first; e < end; e++)
+        if (a->v->events[e].status <= TRACE_BAD_CRC)
+            a->status[task][a->v->events[e].status]++;
+}
+
+/**
+ * @brief Analyzes one trace and prints its line
+ *
+ * @param name (Trace, without extension)
+ * @param config (Ring definition)
+ * @param pool (Workers)
+ * @return int (0 on success, -1 if the trace cannot be read)
+ */
+static int analyze(const char *name, const analyze_config_t *config, pool_t *pool) {
+    trace_view_t v;
+    analyze_t a;
+    uint64_t status[TRACE_BAD_CRC + 1] = {0};
+    uint32_t ticks, formed, t, k, used = 0;
+    uint64_t moving = 0;
+    double var = 0, cv = 0, tick_s, lost_rate;
+    int w, s, ok = 0;
+
+    if (trace_map(&v, name))
+        return -1;
+    if ((uint32_t)config->seed >= v.header->robots) {
+        trace_unmap(&v);
+        return -1;
+    }
+    ticks = v.header->ticks;
+    a.v = &v;
+    a.config = config;
+    a.ticks = calloc(ticks ? ticks : 1, sizeof(analyze_tick_t));
+    a.status = calloc(v.chunks ? v.chunks : 1, sizeof(*a.status));
+    a.angles = calloc(pool_workers(pool), sizeof(double *));
+    if (a.ticks && a.status && a.angles) {
+        ok = 1;
+        for (w = 0; w < pool_workers(pool); w++)
+            ok &= (a.angles[w] = malloc(v.header->robots * sizeof(double))) != NULL;
+    }
+    if (!ok) {
+        fprintf(stderr, "analyze: out of memory\n");
+        exit(1);
+    }
+    pool_run(pool, v.chunks, analyze_chunk, &a);
+
+    //  formation time, then the shape of the ring from there on
+    for (formed = 0; formed < ticks && a.ticks[formed].in_ring < (uint32_t)config->in_first_circle; formed++)
+        ;
+    for (t = 0; t < ticks; t++)
+        moving += a.ticks[t].moving;
+    for (t = formed; t < ticks; t++) {
+        if (isnan(a.ticks[t].radius_var))
+            continue;
+        var += a.ticks[t].radius_var;
+        cv += a.ticks[t].spacing_cv;
+        used++;
+    }
+    for (k = 0; k < v.chunks; k++)
+        for (s = 0; s <= TRACE_BAD_CRC; s++)
+            status[s] += a.status[k][s];
+    tick_s = (double)v.header->tick_cycles / KILO_F_CPU;
+    lost_rate = status[TRACE_RECEIVED] + status[TRACE_LOST] + status[TRACE_DROPPED] ?
+                (double)(status[TRACE_LOST] + status[TRACE_DROPPED]) /
+                (status[TRACE_RECEIVED] + status[TRACE_LOST] + status[TRACE_DROPPED]) : 0;
+
+    printf("%-24s %6u %9.1f ", name, v.header->robots, ticks * tick_s);
+    if (formed < ticks)
+        printf("%9.1f", formed * tick_s);
+    else
+        printf("%9s", "-");
+    printf(" %7u", ticks ? a.ticks[ticks - 1].in_ring : 0);
+    if (used)
+        printf(" %10.2f %10.3f", var / used, cv / used);
+    else
+        printf(" %10s %10s", "-", "-");
+    printf(" %9.1f %9.4f\n", moving * tick_s / v.header->robots, lost_rate);
+
+    for (w = 0; w < pool_workers(pool); w++)
+        free(a.angles[w]);
+    free(a.angles);
+    free(a.status);
+    free(a.ticks);
+    trace_unmap(&v);
+    return 0;
+}
+
+/**
+ * @brief Prints the command line usage
+ *
+ * @param argv0 (Name of the executable)
+ */
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [-c robots] [-d distance] [-e epsilon] [-s seed] [-j threads] trace...\n"
+            "  trace        run recorded with '-o trace' (trace.ktrace and trace.kevents)\n"
+            "  -c robots    robots that make the first circle (default %d)\n"
+            "  -d distance  radius of the first circle around the seed in mm (default %.0f)\n"
+            "  -e epsilon   tolerance on that radius in mm (default %.0f)\n"
+            "  -s seed      kilo_uid of the seed (default 0)\n"
+            "  -j threads   threads (default: one per core)\n"
+            "columns: run, robots, traced seconds, seconds until the circle formed, robots in the ring at the end,\n"
+            "         ring radius variance (mm^2) and angular gap coefficient of variation averaged since then,\n"
+            "         seconds a motor was on per robot, fraction of frames in range lost to collisions or full queues\n",
+            argv0, DEFAULT_IN_FIRST_CIRCLE, DEFAULT_DISTANCE, DEFAULT_EPSILON);
+}
+
+int main(int argc, char **argv) {
+    analyze_config_t config = {DEFAULT_IN_FIRST_CIRCLE, DEFAULT_DISTANCE, DEFAULT_EPSILON, 0};
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN), failed = 0, c;
+    pool_t *pool;
+
+    while ((c = getopt(argc, argv, "c:d:e:s:j:h")) != -1) {
+        switch (c) {
+        case 'c': config.in_first_circle = atoi(optarg); break;
+        case 'd': config.distance = atof(optarg); break;
+        case 'e': config.epsilon = atof(optarg); break;
+        case 's': config.seed = atoi(optarg); break;
+        case 'j': threads = atoi(optarg); break;
+        default: usage(argv[0]); return 2;
+        }
+    }
+    if (optind == argc || config.seed < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    pool = threads > 1 ? pool_create(threads) : NULL;
+
+    printf("%-24s %6s %9s %9s %7s %10s %10s %9s %9s\n", "run", "robots", "time (s)", "formed", "ring", "radius var", "gap cv", "motor (s)", "loss");
+    for (; optind < argc; optind++) {
+        if (analyze(argv[optind], &config, pool)) {
+            fprintf(stderr, "%s: cannot read the trace %s\n", argv[0], argv[optind]);
+            failed = 1;
+        }
+    }
+    if (pool)
+        pool_destroy(pool);
+    return failed;
+}
@@ -0,0 +1,264 @@
+#!/bin/sh
+#
+# @file bench.sh
+# @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+#
+# @brief Singles (singles_circle1.c) against Duos (duos_circle1.c) around the same seed (seed.c):
+#        formation time, energy and messages over matched random layouts, until the difference is settled
+# @version 0.1
+# @date 2026-10-17
+#
+# @copyright Copyright (c) 2026
+#
+# make bench, or make bench BENCH="-n 32,64 -k 96"
+#
+# For each swarm size both programs run on the same placements (run seed k), a batch of placements
+# at a time, on all cores. After each batch the paired differences (duos - singles) of the formation
+# time get a confidence interval at level 1 - alpha/L, L being the most batches a size can take
+# (Bonferroni), so that looking after every batch keeps the overall error below alpha. A size stops
+# once that interval excludes zero, or is narrower than the tolerance (no difference worth having),
+# or after the last placement. A run that never forms its first circle counts as taking the whole
+# run (its formation time is censored), and is counted in the 'formed' column. When more than half
+# of the pairs have a censored run, their differences say nothing of the formation times: the size
+# stays open until its last placement and is reported as censored, not as a difference.
+#
+# OUT/runs.tsv holds every run, OUT/summary.tsv the statistics, also printed at the end.
+
+set -e
+
+usage() {
+    cat >&2 <<EOF
+usage: $0 [-n sizes] [-t seconds] [-b batch] [-k placements] [-a alpha] [-e tolerance] [-j jobs] [-o dir]
+  -n sizes       swarm sizes, seed included (default 16,32,48,64)
+  -t seconds     simulated time of each run (default 2700, a 45 minute trial)
+  -b batch       placements added to each size between two looks, also the fewest (default 8)
+  -k placements  most placements of a size (default 64)
+  -a alpha       error rate of the comparison (default 0.05)
+  -e tolerance   formation time difference too small to matter in s (default 60)
+  -j jobs        runs at a time (default: one per core)
+  -o dir         where builds, runs and tables go (default bench)
+EOF
+    exit 2
+}
+
+sizes=16,32,48,64
+seconds=2700
+batch=8
+placements=64
+alpha=0.05
+tolerance=60
+jobs=$(getconf _NPROCESSORS_ONLN)
+out=bench
+while getopts n:t:b:k:a:e:j:o:h opt; do
+    case $opt in
+    n) sizes=$OPTARG ;;
+    t) seconds=$OPTARG ;;
+    b) batch=$OPTARG ;;
+    k) placements=$OPTARG ;;
+    a) alpha=$OPTARG ;;
+    e) tolerance=$OPTARG ;;
+    j) jobs=$OPTARG ;;
+    o) out=$OPTARG ;;
+    *) usage ;;
+    esac
+done
+shift $((OPTIND - 1))
+[ $# -eq 0 ] && [ "$batch" -ge 2 ] && [ "$placements" -ge "$batch" ] || usage
+sizes=$(echo "$sizes" | tr ',' ' ')
+programs="singles_circle1 duos_circle1"
+
+# make works from the top of the repository
+case $out in
+/*) ;;
+*) out=$PWD/$out ;;
+esac
+cd "$(dirname "$0")/.."
+mkdir -p "$out/build" "$out/bin" "$out/runs"
+
+# value of a #define in a program
+define() {
+    sed -n "s/^#define[ \t]*$2[ \t]*\([0-9]*\).*/\1/p" "$(find src -name "$1.c" -print -quit)" | head -n 1
+}
+
+# one build per program and size: TOTAL_KILOBOTS (16 robots each) sizes their arrays of uids
+echo "building $programs for $(echo $sizes | wc -w) swarm size(s)"
+make -s analyze
+for n in $sizes; do
+    for p in $programs; do
+        make -s host FILENAME="$p.c" SEED=seed.c HOST_DEFINES="-DNUMBER_OF_ROBOTS=256 -DTOTAL_KILOBOTS=$(((n + 15) / 16))" \
+             HOST_OUT="$out/build/$p-$n" HOST_BIN="$out/bin/$p-$n"
+    done
+done
+
+# one run: simulate with a trace, reduce it to a row of OUT/runs.tsv, drop the trace
+export BENCH_OUT="$out" BENCH_SECONDS="$seconds"
+run='
+    t="$BENCH_OUT/runs/$1-$2-s$3"
+    "$BENCH_OUT/bin/$1-$2" -n "$2" -t "$BENCH_SECONDS" -s "$3" -j 1 -o "$t" > "$t.log"
+    channel=$(sed -n "s/^channel: \([0-9]*\) frames sent, [0-9]* aborted by carrier sense, \([0-9]*\) received.*/\1 \2/p" "$t.log")
+    bin/analyze -j 1 -c "$4" -d "$5" -e "$6" "$t" |
+        awk -v size="$2" -v program="$1" -v k="$3" -v channel="$channel" "NR == 2 {
+            split(channel, c, \" \")
+            printf \"%s\t%s\t%s\t%s\t%s\t%s\t%s\n\", size, program, k, \$4, \$8, c[1], c[2]
+        }" > "$t.row"
+    rm -f "$t.ktrace" "$t.kevents"
+'
+
+# statistics of the runs of one size (size=N), as the lines of OUT/summary.tsv, or just whether the
+# comparison is settled (check=1); rows: size, program, placement, formed (s or -), motor (s), sent, received
+stats='
+function erfc(x,    t) {
+    #  Abramowitz and Stegun 7.1.26, x >= 0
+    t = 1 / (1 + 0.3275911 * x)
+    return t * (0.254829592 + t * (-0.284496736 + t * (1.421413741 + t * (-1.453152027 + t * 1.061405429)))) * exp(-x * x)
+}
+function zq(p,    lo, hi, m, i) {
+    #  upper p quantile of the standard normal distribution
+    lo = 0; hi = 10
+    for (i = 0; i < 60; i++) {
+        m = (lo + hi) / 2
+        if (erfc(m / sqrt(2)) / 2 > p) lo = m; else hi = m
+    }
+    return m
+}
+function tq(p, nu,    x) {
+    #  upper p quantile of the t distribution (Cornish-Fisher expansion)
+    x = zq(p)
+    return x + (x^3 + x) / (4 * nu) + (5 * x^5 + 16 * x^3 + 3 * x) / (96 * nu^2) + (3 * x^7 + 19 * x^5 + 17 * x^3 - 15 * x) / (384 * nu^3)
+}
+function summarize(v, n, p,    i, j, x, sum, sum2) {
+    #  mean, bounds of its 1 - 2p interval, quartiles of v[1..n] (sorted in place)
+    for (i = 2; i <= n; i++)
+        for (j = i; j > 1 && v[j - 1] > v[j]; j--) { x = v[j]; v[j] = v[j - 1]; v[j - 1] = x }
+    for (i = 1; i <= n; i++) { sum += v[i]; sum2 += v[i] * v[i] }
+    S["mean"] = sum / n
+    S["hw"] = n > 1 ? tq(p, n - 1) * sqrt((sum2 - sum * sum / n) / (n - 1) / n) : 0
+    S["q1"] = v[int((n - 1) / 4) + 1]
+    S["median"] = n % 2 ? v[(n + 1) / 2] : (v[n / 2] + v[n / 2 + 1]) / 2
+    S["q3"] = v[n - int((n - 1) / 4)]
+}
+function row(program, runs, formed,    k, f) {
+    printf "%s\t%s\t%d\t%s", size, program, runs, formed
+    for (k = 1; k <= 4; k++) {
+        f = k == 1 ? "formation" : k == 2 ? "motor" : k == 3 ? "sent" : "received"
+        printf "\t%.1f\t%.1f\t%.1f\t%s\t%s\t%s", M[f, "mean"], M[f, "mean"] - M[f, "hw"], M[f, "mean"] + M[f, "hw"], M[f, "q1"], M[f, "median"], M[f, "q3"]
+    }
+    printf "\n"
+}
+function measure(name, v, n, p, quartiles,    k) {
+    summarize(v, n, p)
+    for (k in S)
+        M[name, k] = k ~ /^q|median/ && !quartiles ? "-" : k ~ /^q|median/ ? sprintf("%.1f", S[k]) : S[k]
+}
+$1 == size {
+    value[$2, $3] = $4 == "-" ? seconds : $4
+    censored[$2, $3] = $4 == "-"
+    formed[$2] += $4 != "-"
+    motor[$2, $3] = $5; sent[$2, $3] = $6; received[$2, $3] = $7
+    runs[$2]++
+    has[$2, $3] = 1
+}
+END {
+    #  pairs: the placements both programs ran
+    for (key in has) {
+        split(key, kk, SUBSEP)
+        if (kk[1] == a && has[b, kk[2]]) {
+            n++
+            cens += censored[a, kk[2]] || censored[b, kk[2]]
+            d[n] = value[b, kk[2]] - value[a, kk[2]]
+            dm[n] = motor[b, kk[2]] - motor[a, kk[2]]; ds[n] = sent[b, kk[2]] - sent[a, kk[2]]; dr[n] = received[b, kk[2]] - received[a, kk[2]]
+        }
+    }
+    if (n < 2) {
+        if (check) print "open"
+        exit
+    }
+    looks = int((placements + batch - 1) / batch)
+    summarize(d, n, alpha / (2 * looks))
+    #  mostly censored pairs: the interval is about the time limit, not the programs
+    uncensored = 2 * cens <= n
+    settled = uncensored && (S["mean"] - S["hw"] > 0 || S["mean"] + S["hw"] < 0 || S["hw"] < tolerance)
+    if (check) {
+        print (settled || n >= placements ? "settled" : "open")
+        exit
+    }
+    for (i = 1; i <= 2; i++) {
+        p = i == 1 ? a : b
+        m = 0
+        for (key in has) {
+            split(key, kk, SUBSEP)
+            if (kk[1] == p) { m++; v1[m] = value[p, kk[2]]; v2[m] = motor[p, kk[2]]; v3[m] = sent[p, kk[2]]; v4[m] = received[p, kk[2]] }
+        }
+        measure("formation", v1, m, alpha / 2, 1); measure("motor", v2, m, alpha / 2, 1)
+        measure("sent", v3, m, alpha / 2, 1); measure("received", v4, m, alpha / 2, 1)
+        row(p, runs[p], formed[p] + 0)
+    }
+    measure("formation", d, n, alpha / (2 * looks), 0)
+    verdict = S["mean"] - S["hw"] > 0 ? a " faster" : S["mean"] + S["hw"] < 0 ? b " faster" : S["hw"] < tolerance ? "no difference" : "unsettled"
+    if (!uncensored)
+        verdict = sprintf("censored (%d of %d)", cens, n)
+    measure("motor", dm, n, alpha / (2 * looks), 0)
+    measure("sent", ds, n, alpha / (2 * looks), 0); measure("received", dr, n, alpha / (2 * looks), 0)
+    row(b " - " a, n, verdict)
+}'
+statistics() {
+    awk -F '\t' -v size="$1" -v check="$2" -v a=singles_circle1 -v b=duos_circle1 -v seconds="$seconds" -v batch="$batch" \
+        -v placements="$placements" -v alpha="$alpha" -v tolerance="$tolerance" "$stats" "$out/runs.tsv"
+}
+
+# batches, until every size is settled
+: > "$out/runs.tsv"
+open=$sizes
+done=0
+while [ -n "$open" ]; do
+    echo "placements $((done + 1)) to $((done + batch)) of size(s) $open"
+    for n in $open; do
+        for p in $programs; do
+            k=$((done + 1))
+            while [ $k -le $((done + batch)) ]; do
+                echo "$p $n $k $(define $p ROBOTS_IN_FIRST_CIRCLE) $(define $p DESIRED_DISTANCE) $(define $p EPSILON)"
+                k=$((k + 1))
+            done
+        done
+    done | xargs -n 6 -P "$jobs" sh -c "$run" run
+    for n in $open; do
+        for p in $programs; do
+            k=$((done + 1))
+            while [ $k -le $((done + batch)) ]; do
+                cat "$out/runs/$p-$n-s$k.row" >> "$out/runs.tsv"
+                k=$((k + 1))
+            done
+        done
+    done
+    done=$((done + batch))
+    still=
+    for n in $open; do
+        if [ "$(statistics $n 1)" = open ]; then
+            still="$still $n"
+        fi
+    done
+    open=${still# }
+done
+
+# the report
+{
+    printf 'size\tprogram\truns\tformed'
+    for m in formation motor sent received; do
+        printf '\t%s_mean\t%s_lo\t%s_hi\t%s_q1\t%s_median\t%s_q3' $m $m $m $m $m $m
+    done
+    printf '\n'
+    for n in $sizes; do
+        statistics $n 0
+    done
+} > "$out/summary.tsv"
+awk -F '\t' -v alpha="$alpha" 'NR == 1 {
+    printf "%5s %-31s %4s %-22s %-42s %-22s %-28s %-28s\n", "size", "program", "runs", "formed", "formation time (s)", "motor on (s)", "frames sent", "frames received"
+    printf "%5s %-31s %4s %-22s %-42s %-22s %-28s %-28s\n", "", "", "", "", sprintf("mean [%g%% CI], median [q1, q3]", 100 * (1 - alpha)), "mean [CI]", "mean [CI]", "mean [CI]"
+    next
+}
+{
+    q = $8 == "-" ? "" : sprintf(", %s [%s, %s]", $9, $8, $10)
+    printf "%5s %-31s %4s %-22s %-42s %-22s %-28s %-28s\n", $1, $2, $3, $4, sprintf("%s [%s, %s]%s", $5, $6, $7, q),
+           sprintf("%s [%s, %s]", $11, $12, $13), sprintf("%s [%s, %s]", $17, $18, $19), sprintf("%s [%s, %s]", $23, $24, $25)
+}' "$out/summary.tsv"
+echo "every run in $out/runs.tsv, statistics in $out/summary.tsv (the intervals of the differences hold jointly over all looks)"
@@ -0,0 +1,239 @@
+/**
+ * @file bodies.c
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Hot state of the simulated robots and the integrator of their motion
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(BODIES_SCALAR)
+#define BODIES_AVX2
+#include <immintrin.h>
+#endif
+
+#include "bodies.h"
+#include "world.h"
+
+//  pi/2 split so that q * PIO2_HI is exact for small q (fdlibm)
+#define PIO2_HI   1.57079632673412561417e+00
+#define PIO2_LO   6.07710050650619224932e-11
+#define INV_PIO2  6.36619772367581382433e-01
+#define TWO_PI    6.28318530717958647693e+00
+#define INV_2PI   1.59154943091895335769e-01
+
+//  minimax polynomials of sin and cos on [-pi/4, pi/4] (fdlibm __kernel_sin, __kernel_cos)
+#define S1 -1.66666666666666324348e-01
+#define S2  8.33333333332248946124e-03
+#define S3 -1.98412698298579493134e-04
+#define S4  2.75573137070700676789e-06
+#define S5 -2.50507602534068634195e-08
+#define S6  1.58969099521155010221e-10
+#define C1  4.16666666666666019037e-02
+#define C2 -1.38888888888741095749e-03
+#define C3  2.48015872894767294178e-05
+#define C4 -2.75573143513906633035e-07
+#define C5  2.08757232129817482790e-09
+#define C6 -1.13596475577881948265e-11
+
+/**
+ * @brief Grows one column
+ *
+ * @param column (Column, updated)
+ * @param size (Size of an entry)
+ * @param n (Entries in use)
+ * @param capacity (New number of entries)
+ * @return int (0 on success, -1 on allocation failure)
+ */
+static int column_grow(void *column, size_t size, int n, int capacity) {
+    void **c = column;
+    void *p;
+
+    //  round up so that the vector path can always load whole lanes
+    capacity = (capacity + BODIES_LANES - 1) / BODIES_LANES * BODIES_LANES;
+    if (posix_memalign(&p, 64, capacity * size))
+        return -1;
+    memset(p, 0, capacity * size);
+    if (*c)
+        memcpy(p, *c, n * size);
+    free(*c);
+    *c = p;
+    return 0;
+}
+
+int bodies_grow(bodies_t *b, int n, int capacity) {
+    if (column_grow(&b->x, sizeof(double), n, capacity) ||
+        column_grow(&b->y, sizeof(double), n, capacity) ||
+        column_grow(&b->theta, sizeof(double), n, capacity) ||
+        column_grow(&b->gain_left, sizeof(double), n, capacity) ||
+        column_grow(&b->gain_right, sizeof(double), n, capacity) ||
+        column_grow(&b->motor_left, sizeof(uint8_t), n, capacity) ||
+        column_grow(&b->motor_right, sizeof(uint8_t), n, capacity) ||
+        column_grow(&b->color, sizeof(uint8_t), n, capacity) ||
+        column_grow(&b->pushed, sizeof(uint8_t), n, capacity) ||
+        column_grow(&b->awake, sizeof(uint64_t), (n + BODIES_WORD - 1) / BODIES_WORD,
+                    (capacity + BODIES_WORD - 1) / BODIES_WORD))
+        return -1;
+    b->capacity = capacity;
+    return 0;
+}
+
+void bodies_free(bodies_t *b) {
+    free(b->x);
+    free(b->y);
+    free(b->theta);
+    free(b->gain_left);
+    free(b->gain_right);
+    free(b->motor_left);
+    free(b->motor_right);
+    free(b->color);
+    free(b->pushed);
+    free(b->awake);
+    memset(b, 0, sizeof(bodies_t));
+}
+
+/**
+ * @brief Sine and cosine of an angle in about [-pi, pi]
+ *
+ * @param a (Angle, rad)
+ * @param s (Receives the sine)
+ * @param c (Receives the cosine)
+ */
+static inline void body_sincos(double a, double *s, double *c) {
+    double q = nearbyint(a * INV_PIO2);
+    double r = (a - q * PIO2_HI) - q * PIO2_LO;
+    double z = r * r;
+    double sn = r + (r * z) * (S1 + z * (S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)))));
+    double cs = (1.0 - 0.5 * z) + (z * z) * (C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6)))));
+    int k = (int)q & 3;
+
+    *s = k & 1 ? cs : sn;
+    *c = k & 1 ? sn : cs;
+    if (k & 2)
+        *s = -*s;
+    if ((k + 1) & 2)
+        *c = -*c;
+}
+
+/**
+ * @brief Moves one robot for @p dt seconds (see bodies_move())
+ *
+ * @param b (Columns)
+ * @param i (Robot)
+ * @param dt (Duration, s)
+ */
+static inline void body_move(bodies_t *b, int i, double dt) {
+    double dl = b->motor_left[i] * b->gain_left[i];
+    double dr = b->motor_right[i] * b->gain_right[i];
+    double v = (WORLD_SPEED * 0.5) * (dl + dr);
+    double dtheta = (WORLD_TURN_RATE * (dl - dr)) * dt;
+    double step = v * dt;
+    double s, c, t;
+
+    body_sincos(b->theta[i] + 0.5 * dtheta, &s, &c);
+    b->x[i] = b->x[i] + step * c;
+    b->y[i] = b->y[i] + step * s;
+    t = b->theta[i] + dtheta;
+    b->theta[i] = t - nearbyint(t * INV_2PI) * TWO_PI;
+}
+
+#ifdef BODIES_AVX2
+/**
+ * @brief Moves BODIES_LANES robots for @p dt seconds, like body_move() on each
+ *
+ * @param b (Columns)
+ * @param i (First robot, a multiple of BODIES_LANES)
+ * @param dt (Duration, s)
+ */
+__attribute__((target("avx2")))
+static void body_move_avx2(bodies_t *b, int i, double dt) {
+    const __m256d vdt = _mm256_set1_pd(dt);
+    int32_t left, right;
+    __m256d ml, mr, dl, dr, v, dtheta, step, a, q, r, z, sn, cs, s, c, t, moving;
+    __m128i k;
+    __m256i swap, negs, negc;
+
+    memcpy(&left, b->motor_left + i, sizeof(left));
+    memcpy(&right, b->motor_right + i, sizeof(right));
+    ml = _mm256_cvtepi32_pd(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(left)));
+    mr = _mm256_cvtepi32_pd(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(right)));
+    moving = _mm256_cmp_pd(_mm256_add_pd(ml, mr), _mm256_setzero_pd(), _CMP_NEQ_OQ);
+
+    dl = _mm256_mul_pd(ml, _mm256_load_pd(b->gain_left + i));
+    dr = _mm256_mul_pd(mr, _mm256_load_pd(b->gain_right + i));
+    v = _mm256_mul_pd(_mm256_set1_pd(WORLD_SPEED * 0.5), _mm256_add_pd(dl, dr));
+    dtheta = _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(WORLD_TURN_RATE), _mm256_sub_pd(dl, dr)), vdt);
+    step = _mm256_mul_pd(v, vdt);
+
+    //  body_sincos() of the heading at mid-step
+    a = _mm256_add_pd(_mm256_load_pd(b->theta + i), _mm256_mul_pd(_mm256_set1_pd(0.5), dtheta));
+    q = _mm256_round_pd(_mm256_mul_pd(a, _mm256_set1_pd(INV_PIO2)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    r = _mm256_sub_pd(_mm256_sub_pd(a, _mm256_mul_pd(q, _mm256_set1_pd(PIO2_HI))), _mm256_mul_pd(q, _mm256_set1_pd(PIO2_LO)));
+    z = _mm256_mul_pd(r, r);
+    sn = _mm256_add_pd(_mm256_set1_pd(S5), _mm256_mul_pd(z, _mm256_set1_pd(S6)));
+    sn = _mm256_add_pd(_mm256_set1_pd(S4), _mm256_mul_pd(z, sn));
+    sn = _mm256_add_pd(_mm256_set1_pd(S3), _mm256_mul_pd(z, sn));
+    sn = _mm256_add_pd(_mm256_set1_pd(S2), _mm256_mul_pd(z, sn));
+    sn = _mm256_add_pd(_mm256_set1_pd(S1), _mm256_mul_pd(z, sn));
+    sn = _mm256_add_pd(r, _mm256_mul_pd(_mm256_mul_pd(r, z), sn));
+    cs = _mm256_add_pd(_mm256_set1_pd(C5), _mm256_mul_pd(z, _mm256_set1_pd(C6)));
+    cs = _mm256_add_pd(_mm256_set1_pd(C4), _mm256_mul_pd(z, cs));
+    cs = _mm256_add_pd(_mm256_set1_pd(C3), _mm256_mul_pd(z, cs));
+    cs = _mm256_add_pd(_mm256_set1_pd(C2), _mm256_mul_pd(z, cs));
+    cs = _mm256_add_pd(_mm256_set1_pd(C1), _mm256_mul_pd(z, cs));
+    cs = _mm256_add_pd(_mm256_sub_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(_mm256_set1_pd(0.5), z)),
+                       _mm256_mul_pd(_mm256_mul_pd(z, z), cs));
+
+    //  pick and negate by quadrant
+    k = _mm_and_si128(_mm256_cvtpd_epi32(q), _mm_set1_epi32(3));
+    swap = _mm256_cvtepi32_epi64(_mm_cmpeq_epi32(_mm_and_si128(k, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+    negs = _mm256_slli_epi64(_mm256_cvtepi32_epi64(_mm_and_si128(k, _mm_set1_epi32(2))), 62);
+    negc = _mm256_slli_epi64(_mm256_cvtepi32_epi64(_mm_and_si128(_mm_add_epi32(k, _mm_set1_epi32(1)), _mm_set1_epi32(2))), 62);
+    s = _mm256_blendv_pd(sn, cs, _mm256_castsi256_pd(swap));
+    c = _mm256_blendv_pd(cs, sn, _mm256_castsi256_pd(swap));
+    s = _mm256_xor_pd(s, _mm256_castsi256_pd(negs));
+    c = _mm256_xor_pd(c, _mm256_castsi256_pd(negc));
+
+    //  idle robots keep their pose
+    _mm256_store_pd(b->x + i, _mm256_blendv_pd(_mm256_load_pd(b->x + i),
+                    _mm256_add_pd(_mm256_load_pd(b->x + i), _mm256_mul_pd(step, c)), moving));
+    _mm256_store_pd(b->y + i, _mm256_blendv_pd(_mm256_load_pd(b->y + i),
+                    _mm256_add_pd(_mm256_load_pd(b->y + i), _mm256_mul_pd(step, s)), moving));
+    t = _mm256_add_pd(_mm256_load_pd(b->theta + i), dtheta);
+    t = _mm256_sub_pd(t, _mm256_mul_pd(_mm256_round_pd(_mm256_mul_pd(t, _mm256_set1_pd(INV_2PI)),
+                      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC), _mm256_set1_pd(TWO_PI)));
+    _mm256_store_pd(b->theta + i, _mm256_blendv_pd(_mm256_load_pd(b->theta + i), t, moving));
+}
+#endif
+
+void bodies_move(bodies_t *b, int begin, int end, double dt) {
+    int word;
+#ifdef BODIES_AVX2
+    int avx2 = __builtin_cpu_supports("avx2");
+#endif
+
+    for (word = begin / BODIES_WORD; word * BODIES_WORD < end; word++) {
+        uint64_t bits = b->awake[word];
+        while (bits) {
+            //  lanes of the lowest awake robot
+            int lane = __builtin_ctzll(bits) / BODIES_LANES * BODIES_LANES, i = word * BODIES_WORD + lane, k;
+            bits &= ~(((1ULL << BODIES_LANES) - 1) << lane);
+#ifdef BODIES_AVX2
+            if (avx2 && i + BODIES_LANES <= end) {
+                body_move_avx2(b, i, dt);
+                continue;
+            }
+#endif
+            for (k = i; k < i + BODIES_LANES && k < end; k++)
+                if (b->motor_left[k] || b->motor_right[k])
+                    body_move(b, k, dt);
+        }
+    }
+}
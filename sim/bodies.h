@@ -0,0 +1,93 @@
+/**
+ * @file bodies.h
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Hot state of the simulated robots and the integrator of their motion
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef __BODIES_H__
+#define __BODIES_H__
+
+#include <stdint.h>
+
+#define BODIES_LANES 4  // robots integrated together
+#define BODIES_WORD  64 // robots per word of the awake bitmap; motion blocks should start on a multiple of it
+
+/**
+ * @brief Hot state of the robots, one column per field, indexed by robot id.
+ *
+ * The world passes stream through these columns instead of chasing one
+ * robot_t per robot. Each column starts on a cache line.
+ */
+typedef struct {
+    double *x, *y, *theta;               //  pose (mm, mm, rad)
+    double *gain_left, *gain_right;      //  1/duty cycle at which each motor reaches nominal speed
+    uint8_t *motor_left, *motor_right;   //  duty cycles from set_motors()
+    uint8_t *color;                      //  led from set_color()
+    uint8_t *pushed;                     //  moved by a collision in the last world step
+    uint64_t *awake;                     //  one bit per robot with a motor on or pushed, BODIES_WORD per word
+    int capacity;                        //  allocated entries of each column
+} bodies_t;
+
+/**
+ * @brief Grow every column.
+ *
+ * @param b (Columns)
+ * @param n (Entries in use, which are kept)
+ * @param capacity (New number of entries)
+ * @return int (0 on success, -1 on allocation failure)
+ */
+int bodies_grow(bodies_t *b, int n, int capacity);
+
+/**
+ * @brief Release the memory of the columns.
+ *
+ * @param b (Columns)
+ */
+void bodies_free(bodies_t *b);
+
+/**
+ * @brief Set or clear the awake bit of robot @p i after a change of its motors or pushed flag.
+ *
+ * Parked robots, with both motors off and not pushed, stay out of the motion
+ * and collision passes, which skip BODIES_WORD of them per bitmap word.
+ *
+ * @param b (Columns)
+ * @param i (Robot)
+ */
+static inline void bodies_update_awake(bodies_t *b, int i) {
+    uint64_t bit = 1ULL << (i % BODIES_WORD);
+
+    if (b->motor_left[i] || b->motor_right[i] || b->pushed[i])
+        b->awake[i / BODIES_WORD] |= bit;
+    else
+        b->awake[i / BODIES_WORD] &= ~bit;
+}
+
+/**
+ * @brief Move robots @p begin to @p end-1 along their trajectories for @p dt seconds.
+ *
+ * The kilobot's vibration motors drive it forward when both run and make it
+ * pivot when only one runs: each pair of duty cycles maps to a linear and an
+ * angular speed, and the pose follows an arc of constant speed and turn rate
+ * over the step. Robots with both motors off keep their pose exactly; only
+ * the lanes of awake robots are visited.
+ *
+ * Uses AVX2 when the CPU has it (unless built with -DBODIES_SCALAR); the
+ * scalar path does the same operations in the same order, so the poses are
+ * bit-identical either way. Sine and cosine come from polynomials accurate
+ * to a few units in the last place.
+ *
+ * @param b (Columns)
+ * @param begin (First robot, a multiple of BODIES_WORD)
+ * @param end (One past the last robot)
+ * @param dt (Duration, s)
+ */
+void bodies_move(bodies_t *b, int begin, int end, double dt);
+
+#endif//__BODIES_H__
@@ -0,0 +1,180 @@
+/**
+ * @file distance_check.c
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Checks estimate_distance() against the floating point version it replaced over every pair of 10-bit readings
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../kilolib/kilolib.h"
+#include "../kilolib/distance.h"
+#include "../kilolib/distance_reference.h"
+#include "ir.h"
+
+#define GAIN_MIN    0.80    // least sensitive receiver checked, relative to a typical one
+#define GAIN_STEP   0.05
+#define GAIN_STEPS  9       // up to 1.20, beyond the 0.9 to 1.1 of the simulated swarms
+#define RANDOM      64      // random calibration tables checked, of each kind
+#define SHOWN       8       // mismatches printed
+
+uint16_t kilo_irhigh[14];  // calibration of the receiver being checked, read by every version
+uint16_t kilo_irlow[14];
+
+/**
+ * @brief Mismatches so far.
+ */
+typedef struct {
+    uint64_t pairs;         //  readings checked
+    uint64_t differ;        //  estimates that differ from the floating point one
+    uint64_t far;           //  of which by more than 1 mm
+    int shown;
+} check_t;
+
+/**
+ * @brief Seconds since an arbitrary point
+ *
+ * @return double (Seconds)
+ */
+static double now(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Times one version over every pair of readings
+ *
+ * @param f (estimate_distance, estimate_distance_scan or estimate_distance_reference)
+ * @return double (Nanoseconds per call)
+ */
+static double time_calls(uint8_t (*f)(const distance_measurement_t *)) {
+    distance_measurement_t d;
+    volatile uint8_t sink;
+    double start = now();
+
+    for (d.high_gain = 0; d.high_gain < 1024; d.high_gain++)
+        for (d.low_gain = 0; d.low_gain < 1024; d.low_gain++)
+            sink = f(&d);
+    (void)sink;
+    return (now() - start) * 1e9 / (1024 * 1024);
+}
+
+/**
+ * @brief Compares one estimate with the floating point one
+ *
+ * @param c (Mismatches)
+ * @param what (Receiver, for the message)
+ * @param version (Name of the version)
+ * @param d (Readings)
+ * @param estimate (Its estimate)
+ * @param reference (Floating point estimate)
+ */
+static void compare(check_t *c, const char *what, const char *version, const distance_measurement_t *d,
+                    int estimate, int reference) {
+    if (estimate == reference)
+        return;
+    c->differ++;
+    c->far += abs(estimate - reference) > 1;
+    if (c->shown++ < SHOWN)
+        printf("%s, high %d low %d: %s %d mm, floating point %d mm\n",
+               what, d->high_gain, d->low_gain, version, estimate, reference);
+}
+
+/**
+ * @brief Checks every version over every pair of readings, with the tables in kilo_irhigh and kilo_irlow
+ *
+ * @param c (Mismatches)
+ * @param what (Receiver, for the messages)
+ */
+static void check(check_t *c, const char *what) {
+    distance_measurement_t d;
+
+    distance_lut_init();
+    for (d.high_gain = 0; d.high_gain < 1024; d.high_gain++) {
+        for (d.low_gain = 0; d.low_gain < 1024; d.low_gain++) {
+            int reference = estimate_distance_reference(&d);
+            compare(c, what, "table", &d, estimate_distance(&d), reference);
+            compare(c, what, "scan", &d, estimate_distance_scan(&d), reference);
+            c->pairs++;
+        }
+    }
+}
+
+/**
+ * @brief Random calibration table with distinct neighbours, which the floating point version can divide by
+ *
+ * @param table (Receives the samples)
+ * @param sorted (Decreasing, as a real receiver's, or in any order)
+ */
+static void random_table(uint16_t *table, int sorted) {
+    int i, j;
+    uint16_t t;
+
+    do {
+        for (i = 0; i < 14; i++)
+            table[i] = rand() % 1024;
+        if (sorted) {
+            for (i = 0; i < 14; i++)
+                for (j = i + 1; j < 14; j++)
+                    if (table[j] > table[i]) {
+                        t = table[i];
+                        table[i] = table[j];
+                        table[j] = t;
+                    }
+        }
+        for (i = 1; i < 14 && table[i] != table[i-1]; i++)
+            ;
+    } while (i < 14);
+}
+
+int main(void) {
+    ir_profile_t *p = malloc(sizeof(ir_profile_t));
+    check_t c;
+    char what[64];
+    int h, l, k, failed;
+
+    if (!p) {
+        fprintf(stderr, "distance_check: out of memory\n");
+        return 1;
+    }
+    memset(&c, 0, sizeof(c));
+    //  receivers of every sensitivity the simulator gives, and some beyond
+    for (h = 0; h < GAIN_STEPS; h++) {
+        for (l = 0; l < GAIN_STEPS; l++) {
+            ir_profile_init(p, GAIN_MIN + h*GAIN_STEP, GAIN_MIN + l*GAIN_STEP);
+            memcpy(kilo_irhigh, p->cal_high, sizeof(kilo_irhigh));
+            memcpy(kilo_irlow, p->cal_low, sizeof(kilo_irlow));
+            snprintf(what, sizeof(what), "gains %.2f/%.2f", GAIN_MIN + h*GAIN_STEP, GAIN_MIN + l*GAIN_STEP);
+            check(&c, what);
+        }
+    }
+    printf("%llu readings of %d receivers: %llu estimates differ, %llu by more than 1 mm\n",
+           (unsigned long long)c.pairs, GAIN_STEPS*GAIN_STEPS, (unsigned long long)c.differ, (unsigned long long)c.far);
+    printf("host time per call: %.1f ns table, %.1f ns scan, %.1f ns floating point (see distance_benchmark.c for AVR cycles)\n",
+           time_calls(estimate_distance), time_calls(estimate_distance_scan), time_calls(estimate_distance_reference));
+
+    //  tables no receiver has, decreasing ones looked up in the table, the others scanned
+    failed = c.far != 0;
+    memset(&c, 0, sizeof(c));
+    srand(1);
+    for (k = 0; k < 2*RANDOM; k++) {
+        random_table(kilo_irhigh, k < RANDOM);
+        random_table(kilo_irlow, k < RANDOM);
+        snprintf(what, sizeof(what), "random tables %d", k);
+        check(&c, what);
+    }
+    printf("%llu readings of %d random tables: %llu estimates differ, %llu by more than 1 mm\n",
+           (unsigned long long)c.pairs, 2*RANDOM, (unsigned long long)c.differ, (unsigned long long)c.far);
+    free(p);
+    return failed || c.far ? 1 : 0;
+}
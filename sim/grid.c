@@ -0,0 +1,235 @@
+/**
+ * @file grid.c
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Spatial hash of robot positions for neighbor queries
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "grid.h"
+
+#define GRID_MIN_BUCKETS 64
+
+/**
+ * @brief Bucket of a cell
+ *
+ * @param g (Grid)
+ * @param cx (Cell column)
+ * @param cy (Cell row)
+ * @return uint32_t (Bucket index)
+ */
+static inline uint32_t grid_hash(const grid_t *g, int32_t cx, int32_t cy) {
+    return ((uint32_t)cx * 0x9E3779B1u ^ (uint32_t)cy * 0x85EBCA77u) & g->mask;
+}
+
+/**
+ * @brief Cell coordinate of a position
+ *
+ * @param g (Grid)
+ * @param v (Position, mm)
+ * @return int32_t (Cell coordinate)
+ */
+static inline int32_t grid_cell(const grid_t *g, double v) {
+    return (int32_t)floor(v / g->cell);
+}
+
+/**
+ * @brief Puts an entry at the front of the bucket of its cell
+ *
+ * @param g (Grid)
+ * @param id (Entry)
+ */
+static void grid_link(grid_t *g, int id) {
+    uint32_t b = grid_hash(g, g->cx[id], g->cy[id]);
+    g->prev[id] = -1;
+    g->next[id] = g->head[b];
+    if (g->head[b] >= 0)
+        g->prev[g->head[b]] = id;
+    g->head[b] = id;
+}
+
+/**
+ * @brief Removes an entry from its bucket
+ *
+ * @param g (Grid)
+ * @param id (Entry)
+ */
+static void grid_unlink(grid_t *g, int id) {
+    if (g->prev[id] >= 0)
+        g->next[g->prev[id]] = g->next[id];
+    else
+        g->head[grid_hash(g, g->cx[id], g->cy[id])] = g->next[id];
+    if (g->next[id] >= 0)
+        g->prev[g->next[id]] = g->prev[id];
+}
+
+/**
+ * @brief Changes the number of buckets and rehashes every entry
+ *
+ * @param g (Grid)
+ * @param buckets (New number of buckets, a power of two)
+ * @return int (0 on success, -1 on allocation failure)
+ */
+static int grid_rehash(grid_t *g, uint32_t buckets) {
+    int32_t *head = malloc(buckets * sizeof(int32_t));
+    uint32_t *stamp = head ? malloc(buckets * sizeof(uint32_t)) : NULL;
+    uint32_t b;
+    int i;
+
+    if (!stamp) {
+        free(head);
+        return -1;
+    }
+    free(g->head);
+    free(g->stamp);
+    g->head = head;
+    g->stamp = stamp;
+    g->mask = buckets - 1;
+    //  every entry lands in a new bucket: all of them changed
+    g->clock++;
+    for (b = 0; b < buckets; b++) {
+        head[b] = -1;
+        stamp[b] = g->clock;
+    }
+    for (i = 0; i < g->n; i++)
+        grid_link(g, i);
+    return 0;
+}
+
+int grid_init(grid_t *g, double cell) {
+    g->cell = cell;
+    g->head = NULL;
+    g->next = g->prev = g->cx = g->cy = NULL;
+    g->stamp = NULL;
+    g->clock = 0;
+    g->n = g->capacity = 0;
+    return grid_rehash(g, GRID_MIN_BUCKETS);
+}
+
+void grid_free(grid_t *g) {
+    free(g->head);
+    free(g->next);
+    free(g->prev);
+    free(g->cx);
+    free(g->cy);
+    free(g->stamp);
+    g->head = g->next = g->prev = g->cx = g->cy = NULL;
+    g->stamp = NULL;
+    g->n = g->capacity = 0;
+}
+
+/**
+ * @brief Grows one per-entry array
+ *
+ * @param a (Array, updated)
+ * @param capacity (New number of elements)
+ * @return int (0 on success, -1 on allocation failure)
+ */
+static int grid_grow(int32_t **a, int capacity) {
+    int32_t *p = realloc(*a, capacity * sizeof(int32_t));
+    if (!p)
+        return -1;
+    *a = p;
+    return 0;
+}
+
+int grid_insert(grid_t *g, double x, double y) {
+    int id = g->n;
+
+    if (id == g->capacity) {
+        int capacity = g->capacity ? 2*g->capacity : GRID_MIN_BUCKETS;
+        if (grid_grow(&g->next, capacity) || grid_grow(&g->prev, capacity) ||
+            grid_grow(&g->cx, capacity) || grid_grow(&g->cy, capacity))
+            return -1;
+        g->capacity = capacity;
+    }
+    if ((uint32_t)(id + 1) * 2 > g->mask + 1 && grid_rehash(g, 2 * (g->mask + 1)))
+        return -1;
+    g->cx[id] = grid_cell(g, x);
+    g->cy[id] = grid_cell(g, y);
+    g->n++;
+    grid_link(g, id);
+    g->clock++;
+    grid_touch(g, id);
+    return id;
+}
+
+void grid_tick(grid_t *g) {
+    g->clock++;
+}
+
+void grid_touch(grid_t *g, int id) {
+    //  concurrent callers all store the same value
+    __atomic_store_n(&g->stamp[grid_hash(g, g->cx[id], g->cy[id])], g->clock, __ATOMIC_RELAXED);
+}
+
+int grid_unchanged(const grid_t *g, const uint32_t *buckets, int n, uint32_t since) {
+    int k;
+
+    for (k = 0; k < n; k++)
+        if (g->stamp[buckets[k]] > since)
+            return 0;
+    return 1;
+}
+
+int grid_changed(const grid_t *g, int id, double x, double y) {
+    return grid_cell(g, x) != g->cx[id] || grid_cell(g, y) != g->cy[id];
+}
+
+void grid_update(grid_t *g, int id, double x, double y) {
+    int32_t cx = grid_cell(g, x), cy = grid_cell(g, y);
+
+    grid_touch(g, id);
+    if (cx == g->cx[id] && cy == g->cy[id])
+        return;
+    grid_unlink(g, id);
+    g->cx[id] = cx;
+    g->cy[id] = cy;
+    grid_link(g, id);
+    grid_touch(g, id);
+}
+
+/**
+ * @brief Distinct buckets of a block of cells
+ *
+ * @param g (Grid)
+ * @param x0 (First column)
+ * @param x1 (Last column)
+ * @param y0 (First row)
+ * @param y1 (Last row)
+ * @param buckets (Receives the bucket indices)
+ * @return int (Number of buckets)
+ */
+static int grid_block(const grid_t *g, int32_t x0, int32_t x1, int32_t y0, int32_t y1, uint32_t *buckets) {
+    int32_t cx, cy;
+    int n = 0, k;
+
+    for (cx = x0; cx <= x1; cx++) {
+        for (cy = y0; cy <= y1; cy++) {
+            uint32_t b = grid_hash(g, cx, cy);
+            //  two cells of the block can share a bucket; visit it once
+            for (k = 0; k < n; k++)
+                if (buckets[k] == b)
+                    break;
+            if (k == n)
+                buckets[n++] = b;
+        }
+    }
+    return n;
+}
+
+int grid_neighborhood(const grid_t *g, double x, double y, uint32_t *buckets) {
+    int32_t cx = grid_cell(g, x), cy = grid_cell(g, y);
+    return grid_block(g, cx - 1, cx + 1, cy - 1, cy + 1, buckets);
+}
+
+int grid_nearby(const grid_t *g, double x, double y, double r, uint32_t *buckets) {
+    return grid_block(g, grid_cell(g, x - r), grid_cell(g, x + r), grid_cell(g, y - r), grid_cell(g, y + r), buckets);
+}
@@ -0,0 +1,155 @@
+/**
+ * @file grid.h
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Spatial hash of robot positions for neighbor queries
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef __GRID_H__
+#define __GRID_H__
+
+#include <stdint.h>
+
+/**
+ * @brief Uniform grid over the unbounded arena, stored as a hash of its cells.
+ *
+ * Every entry (robot) lives in the cell that contains its position; all the
+ * entries within one cell size of a point are in the 3x3 block of cells
+ * around it. Cells hash to a power-of-two number of buckets kept at least
+ * twice the number of entries, and each bucket is an intrusive doubly linked
+ * list, so inserting, moving and querying are O(1) on average.
+ *
+ * Each bucket also carries a stamp, the clock value when an entry in it last
+ * moved, came or left; callers caching what they found around a point can
+ * check that none of the buckets changed since.
+ */
+typedef struct {
+    double cell;        //  cell size (mm)
+    uint32_t mask;      //  number of buckets - 1
+    int32_t *head;      //  first entry of each bucket, -1 if empty
+    int32_t *next;      //  next entry in the same bucket, -1 at the end
+    int32_t *prev;      //  previous entry in the same bucket, -1 at the start
+    int32_t *cx, *cy;   //  cell of each entry
+    uint32_t *stamp;    //  clock value of the last change in each bucket
+    uint32_t clock;     //  current period, see grid_tick()
+    int n;              //  number of entries
+    int capacity;       //  allocated size of the per-entry arrays
+} grid_t;
+
+#define GRID_NEIGHBORHOOD 9  // buckets visited by grid_neighborhood()
+#define GRID_NEARBY_MAX   25 // buckets visited by grid_nearby() with a radius of up to two cell sizes
+
+/**
+ * @brief Initialize an empty grid.
+ *
+ * @param g (Grid)
+ * @param cell (Cell size; queries find everything within this distance)
+ * @return int (0 on success, -1 on allocation failure)
+ */
+int grid_init(grid_t *g, double cell);
+
+/**
+ * @brief Release the memory of a grid.
+ *
+ * @param g (Grid)
+ */
+void grid_free(grid_t *g);
+
+/**
+ * @brief Add an entry; entries are numbered 0, 1, 2... in insertion order.
+ *
+ * @param g (Grid)
+ * @param x (Position, mm)
+ * @param y (Position, mm)
+ * @return int (Number of the new entry, or -1 on allocation failure)
+ */
+int grid_insert(grid_t *g, double x, double y);
+
+/**
+ * @brief Record the new position of entry @p id.
+ *
+ * @param g (Grid)
+ * @param id (Entry)
+ * @param x (Position, mm)
+ * @param y (Position, mm)
+ */
+void grid_update(grid_t *g, int id, double x, double y);
+
+/**
+ * @brief Start a new period: changes from now on get a later stamp than any so far.
+ *
+ * @param g (Grid)
+ */
+void grid_tick(grid_t *g);
+
+/**
+ * @brief Stamp the bucket of entry @p id, whose position changed within its cell.
+ *
+ * Safe to call concurrently for different entries; grid_update() stamps by
+ * itself.
+ *
+ * @param g (Grid)
+ * @param id (Entry)
+ */
+void grid_touch(grid_t *g, int id);
+
+/**
+ * @brief Check that no entry of the given buckets moved, came or left after period @p since.
+ *
+ * @param g (Grid)
+ * @param buckets (Bucket indices, e.g. from grid_neighborhood())
+ * @param n (Number of buckets)
+ * @param since (Clock value when the buckets were last looked at)
+ * @return int (Non-zero if none of them changed)
+ */
+int grid_unchanged(const grid_t *g, const uint32_t *buckets, int n, uint32_t since);
+
+/**
+ * @brief Check whether a new position of entry @p id lies in another cell.
+ *
+ * Unlike grid_update() this does not modify the grid, so it can run
+ * concurrently for different entries.
+ *
+ * @param g (Grid)
+ * @param id (Entry)
+ * @param x (Position, mm)
+ * @param y (Position, mm)
+ * @return int (Non-zero if grid_update() would move the entry)
+ */
+int grid_changed(const grid_t *g, int id, double x, double y);
+
+/**
+ * @brief Find the buckets that hold every entry within one cell size of (x, y).
+ *
+ * The buckets may also hold entries further away; callers check the distance.
+ *
+ * @param g (Grid)
+ * @param x (Position, mm)
+ * @param y (Position, mm)
+ * @param buckets (Receives up to GRID_NEIGHBORHOOD distinct bucket indices)
+ * @return int (Number of buckets)
+ */
+int grid_neighborhood(const grid_t *g, double x, double y, uint32_t *buckets);
+
+/**
+ * @brief Find the buckets that hold every entry within @p r of (x, y), for @p r up to two cell sizes.
+ *
+ * Only the cells that touch the square of side 2 @p r around the point are
+ * visited: for a radius below half the cell size, between one and four of
+ * them, against nine for grid_neighborhood().
+ *
+ * @param g (Grid)
+ * @param x (Position, mm)
+ * @param y (Position, mm)
+ * @param r (Search radius, mm, at most twice the cell size)
+ * @param buckets (Receives up to GRID_NEARBY_MAX distinct bucket indices)
+ * @return int (Number of buckets)
+ */
+int grid_nearby(const grid_t *g, double x, double y, double r, uint32_t *buckets);
+
+#endif//__GRID_H__
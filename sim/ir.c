@@ -0,0 +1,72 @@
+/**
+ * @file ir.c
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Response of the simulated IR receivers, tabulated per calibration profile
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <math.h>
+
+#include "ir.h"
+
+/** Response of a typical receiver (see the calibration data in kilo_irhigh/kilo_irlow), sampled every 5 mm from 33 mm. */
+static const uint16_t default_irhigh[14] = {1000, 880, 780, 695, 625, 565, 515, 470, 432, 398, 368, 342, 318, 297};
+static const uint16_t default_irlow[14] = {620, 520, 440, 378, 328, 288, 255, 228, 205, 186, 170, 156, 144, 133};
+
+/**
+ * @brief Clamps a response to the range of the 10-bit ADC
+ *
+ * @param v (Response)
+ * @return uint16_t (ADC reading)
+ */
+static uint16_t adc_clamp(double v) {
+    if (v < 0)
+        return 0;
+    if (v > 1023)
+        return 1023;
+    return (uint16_t)lround(v);
+}
+
+/**
+ * @brief Smooth curve through the samples of a typical receiver
+ *
+ * Catmull-Rom spline between the samples, straight lines beyond them.
+ *
+ * @param samples (Samples every IR_CAL_STEP mm from IR_CAL_FIRST mm)
+ * @param d (Distance, mm)
+ * @return double (Response)
+ */
+static double ir_curve(const uint16_t *samples, double d) {
+    double x = (d - IR_CAL_FIRST) / IR_CAL_STEP, t, m0, m1;
+    int i;
+
+    if (x <= 0)
+        return samples[0] + x * ((double)samples[1] - samples[0]);
+    if (x >= 13)
+        return samples[13] + (x - 13) * ((double)samples[13] - samples[12]);
+    i = (int)x;
+    t = x - i;
+    //  tangents from the neighbouring samples, one-sided at the ends
+    m0 = i > 0 ? 0.5 * ((double)samples[i+1] - samples[i-1]) : (double)samples[1] - samples[0];
+    m1 = i < 12 ? 0.5 * ((double)samples[i+2] - samples[i]) : (double)samples[13] - samples[12];
+    return (2*t*t*t - 3*t*t + 1) * samples[i] + (t*t*t - 2*t*t + t) * m0 +
+           (-2*t*t*t + 3*t*t) * samples[i+1] + (t*t*t - t*t) * m1;
+}
+
+void ir_profile_init(ir_profile_t *p, double gain_high, double gain_low) {
+    int i;
+
+    for (i = 0; i < IR_LUT_SIZE; i++) {
+        p->high[i] = adc_clamp(gain_high * ir_curve(default_irhigh, i * IR_LUT_STEP));
+        p->low[i] = adc_clamp(gain_low * ir_curve(default_irlow, i * IR_LUT_STEP));
+    }
+    for (i = 0; i < 14; i++) {
+        p->cal_high[i] = adc_clamp(gain_high * default_irhigh[i]);
+        p->cal_low[i] = adc_clamp(gain_low * default_irlow[i]);
+    }
+}
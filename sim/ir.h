@@ -0,0 +1,59 @@
+/**
+ * @file ir.h
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Response of the simulated IR receivers, tabulated per calibration profile
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef __IR_H__
+#define __IR_H__
+
+#include <stdint.h>
+
+#define IR_PROFILES   16    // distinct receivers in a swarm; each robot gets one of them
+#define IR_LUT_STEP   0.25  // distance between two entries of the response tables (mm)
+#define IR_LUT_SIZE   512   // entries of the response tables, from 0 to 127.75 mm
+#define IR_CAL_FIRST  33.0  // distance of the first factory calibration sample (mm)
+#define IR_CAL_STEP   5.0   // distance between two factory calibration samples (mm)
+
+/**
+ * @brief One receiver: its actual response and the factory calibration stored in its EEPROM.
+ *
+ * The actual response is a smooth curve through the calibration samples, so
+ * estimate_distance(), which interpolates the samples linearly, gets the same
+ * biased readings between them as on the real robots.
+ */
+typedef struct {
+    uint16_t high[IR_LUT_SIZE];   //  high gain ADC reading every IR_LUT_STEP mm
+    uint16_t low[IR_LUT_SIZE];    //  low gain ADC reading every IR_LUT_STEP mm
+    uint16_t cal_high[14];        //  kilo_irhigh: high gain reading at 33, 38, ... 98 mm
+    uint16_t cal_low[14];         //  kilo_irlow: low gain reading at 33, 38, ... 98 mm
+} ir_profile_t;
+
+/**
+ * @brief Tabulate a receiver that is @p gain_high and @p gain_low times as sensitive as a typical one.
+ *
+ * @param p (Profile to fill)
+ * @param gain_high (Sensitivity of the high gain channel, 1 for a typical receiver)
+ * @param gain_low (Sensitivity of the low gain channel, 1 for a typical receiver)
+ */
+void ir_profile_init(ir_profile_t *p, double gain_high, double gain_low);
+
+/**
+ * @brief Reading of a receiver channel at a given distance.
+ *
+ * @param table (high or low of a profile)
+ * @param d (Centre-to-centre distance, mm)
+ * @return int16_t (10-bit ADC reading)
+ */
+static inline int16_t ir_lookup(const uint16_t *table, double d) {
+    int i = (int)(d * (1.0/IR_LUT_STEP) + 0.5);
+    return table[i < IR_LUT_SIZE ? i : IR_LUT_SIZE - 1];
+}
+
+#endif//__IR_H__
@@ -0,0 +1,251 @@
+/**
+ * @file main.c
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Command line front end of the kilobot swarm simulator
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "world.h"
+
+#define DEFAULT_ROBOTS     8       // robots in the arena, seed included
+#define DEFAULT_DURATION   2700.0  // simulated seconds (a 45 minute trial)
+#define DEFAULT_RADIUS     300.0   // radius of the disc the planets are dropped in (mm)
+#define MIN_SEPARATION     40.0    // minimum centre-to-centre distance at placement (mm)
+#define AREA_PER_ROBOT     3200.0  // placement disc area per robot when -r is not given (mm^2)
+#define TABLE_MAX_ROBOTS   64      // largest swarm whose robots are listed one by one
+
+/**
+ * @brief Prints the command line usage
+ *
+ * @param argv0 (Name of the executable)
+ */
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [-n robots] [-t seconds] [-s seed] [-r radius] [-j threads] [-i noise] [-o trace] [-b branches -f seconds] [-v]\n"
+            "  -n robots   number of robots, seed included (default %d)\n"
+            "  -t seconds  simulated time (default %.0f)\n"
+            "  -s seed     seed of the run (default 1)\n"
+            "  -r radius   radius of the placement disc in mm (default %.0f, larger for big swarms)\n"
+            "  -j threads  threads of the world passes (default: one per core), or with -b branches run at a time\n"
+            "  -i noise    standard deviation of the IR readings in ADC counts (default 0)\n"
+            "  -o trace    record the run in trace.ktrace and trace.kevents (each branch in trace-k.ktrace and trace-k.kevents)\n"
+            "  -b branches simulate until -f seconds once, then continue from there in this many branches, each drawing\n"
+            "              its own random numbers, and print the totals of each\n"
+            "  -f seconds  when the run branches\n"
+            "  -v          print the robots' debug output\n",
+            argv0, DEFAULT_ROBOTS, DEFAULT_DURATION, DEFAULT_RADIUS);
+}
+
+/**
+ * @brief Wall-clock time
+ *
+ * @return double (Seconds since an arbitrary origin)
+ */
+static double wall_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Checks a candidate position against the robots placed so far
+ *
+ * @param w (World)
+ * @param x (Position, mm)
+ * @param y (Position, mm)
+ * @return int (Non-zero if a robot is closer than MIN_SEPARATION)
+ */
+static int too_close(const world_t *w, double x, double y) {
+    uint32_t buckets[GRID_NEIGHBORHOOD];
+    int n = grid_neighborhood(&w->grid, x, y, buckets);
+    int k, i;
+
+    for (k = 0; k < n; k++)
+        for (i = w->grid.head[buckets[k]]; i >= 0; i = w->grid.next[i])
+            if (hypot(x - w->bodies.x[i], y - w->bodies.y[i]) < MIN_SEPARATION)
+                return 1;
+    return 0;
+}
+
+/**
+ * @brief Drops the robots at random, non-overlapping positions
+ *
+ * With a seed program linked in, robot 0 runs it from the origin.
+ *
+ * @param w (World)
+ * @param n (Number of robots)
+ * @param radius (Radius of the placement disc, mm)
+ * @return int (0 on success, -1 if the robots do not fit)
+ */
+static int place_robots(world_t *w, int n, double radius) {
+    int i, tries;
+
+    srand48((long)w->config.seed);
+    for (i = 0; i < n; i++) {
+        const kilobot_program_t *program = &kilobot_program_planet;
+        double x = 0, y = 0;
+
+        if (i == 0 && &kilobot_program_seed) {
+            program = &kilobot_program_seed;
+        } else {
+            for (tries = 0; tries < 10000; tries++) {
+                double a = 2*M_PI*drand48(), d = radius*sqrt(drand48());
+                x = d*cos(a);
+                y = d*sin(a);
+                if (!too_close(w, x, y))
+                    break;
+            }
+            if (tries == 10000)
+                return -1;
+        }
+        if (!world_add_robot(w, program, x, y, 2*M_PI*drand48() - M_PI))
+            return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Prints the totals of the IR channel
+ *
+ * @param w (World)
+ */
+static void print_channel(const world_t *w) {
+    uint64_t sent = 0, aborted = 0, received = 0, lost = 0, dropped = 0;
+    int i;
+
+    for (i = 0; i < w->n; i++) {
+        sent += w->robots[i]->messages_sent;
+        aborted += w->robots[i]->messages_aborted;
+        received += w->robots[i]->messages_received;
+        lost += w->robots[i]->messages_lost;
+        dropped += w->robots[i]->messages_dropped;
+    }
+    printf("channel: %llu frames sent, %llu aborted by carrier sense, %llu received, %llu lost to collisions, "
+           "%llu dropped by full receive queues\n",
+           (unsigned long long)sent, (unsigned long long)aborted, (unsigned long long)received, (unsigned long long)lost,
+           (unsigned long long)dropped);
+}
+
+int main(int argc, char **argv) {
+    world_config_t config = {1, 0, 0, 0};
+    int n = DEFAULT_ROBOTS;
+    double duration = DEFAULT_DURATION, radius = 0;
+    double start, elapsed, fork_at = 0;
+    const char *trace = NULL;
+    char *branch_trace;
+    world_t *w;
+    int branches = 0, jobs = 0, c, i;
+
+    config.threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    while ((c = getopt(argc, argv, "n:t:s:r:j:i:o:b:f:vh")) != -1) {
+        switch (c) {
+        case 'n': n = atoi(optarg); break;
+        case 't': duration = atof(optarg); break;
+        case 's': config.seed = strtoull(optarg, NULL, 0); break;
+        case 'r': radius = atof(optarg); break;
+        case 'j': config.threads = atoi(optarg); break;
+        case 'i': config.ir_noise = atof(optarg); break;
+        case 'o': trace = optarg; break;
+        case 'b': branches = atoi(optarg); break;
+        case 'f': fork_at = atof(optarg); break;
+        case 'v': config.verbose = 1; break;
+        default: usage(argv[0]); return 2;
+        }
+    }
+    if (n < 1 || duration <= 0 || branches < 0 || (branches && (fork_at <= 0 || fork_at >= duration))) {
+        usage(argv[0]);
+        return 2;
+    }
+    //  branches run side by side, each on a single thread
+    if (branches) {
+        jobs = config.threads;
+        config.threads = 1;
+    }
+    if (radius <= 0)
+        radius = fmax(DEFAULT_RADIUS, sqrt(n * AREA_PER_ROBOT / M_PI));
+
+    w = world_create(&config);
+    if (!w || place_robots(w, n, radius)) {
+        fprintf(stderr, "%s: cannot place %d robots within %.0f mm\n", argv[0], n, radius);
+        return 1;
+    }
+    if (trace && !(w->trace = trace_create(trace, w->n, config.seed))) {
+        fprintf(stderr, "%s: cannot create the trace %s\n", argv[0], trace);
+        return 1;
+    }
+
+    start = wall_time();
+    if (branches) {
+        world_run(w, (kilo_cycles_t)(fork_at * KILO_F_CPU));
+        printf("%s: %d robots, %.1f s simulated in %.3f s, branching into %d\n",
+               kilobot_program_planet.name, n, w->now / (double)KILO_F_CPU, wall_time() - start, branches);
+        i = world_fork(w, branches, jobs);
+        if (i <= 0) {
+            //  the parent keeps the opening: its trace ends where the branches start
+            if (w->trace && trace_close(w->trace))
+                fprintf(stderr, "%s: cannot write the trace %s\n", argv[0], trace);
+            w->trace = NULL;
+            world_destroy(w);
+            if (i < 0)
+                fprintf(stderr, "%s: some branches failed\n", argv[0]);
+            return i < 0 ? 1 : 0;
+        }
+        //  the lines of a branch reach stdout together, in a single write at exit
+        setvbuf(stdout, NULL, _IOFBF, BUFSIZ);
+        if (w->trace) {
+            branch_trace = malloc(strlen(trace) + 16);
+            if (!branch_trace)
+                return 1;
+            sprintf(branch_trace, "%s-%d", trace, w->branch);
+            if (trace_branch(w->trace, branch_trace)) {
+                fprintf(stderr, "%s: cannot create the trace %s\n", argv[0], branch_trace);
+                return 1;
+            }
+            trace = branch_trace;
+        }
+        start = wall_time();
+    }
+    world_run(w, (kilo_cycles_t)(duration * KILO_F_CPU));
+    elapsed = wall_time() - start;
+    if (w->trace && trace_close(w->trace)) {
+        fprintf(stderr, "%s: cannot write the trace %s\n", argv[0], trace);
+        return 1;
+    }
+    w->trace = NULL;
+
+    if (w->branch)
+        printf("%s branch %u: %d robots, %.1f s simulated, the last %.1f s in %.3f s\n",
+               kilobot_program_planet.name, w->branch, n, w->now / (double)KILO_F_CPU, duration - fork_at, elapsed);
+    else
+        printf("%s: %d robots, %.1f s simulated in %.3f s (%.0fx real time)\n",
+               kilobot_program_planet.name, n, w->now / (double)KILO_F_CPU, elapsed,
+               w->now / (double)KILO_F_CPU / (elapsed > 0 ? elapsed : 1e-9));
+    print_channel(w);
+    //  the branches print their totals only, or their tables would interleave
+    if (w->n > TABLE_MAX_ROBOTS || w->branch) {
+        world_destroy(w);
+        return 0;
+    }
+    printf("%4s %-16s %9s %9s %8s %6s %8s %8s\n", "uid", "program", "x (mm)", "y (mm)", "theta", "color", "tx", "rx");
+    for (i = 0; i < w->n; i++) {
+        robot_t *r = w->robots[i];
+        printf("%4d %-16s %9.1f %9.1f %8.3f %6u %8u %8u%s\n", r->id, r->program->name,
+               w->bodies.x[i], w->bodies.y[i], w->bodies.theta[i], w->bodies.color[i],
+               r->messages_sent, r->messages_received, r->halted ? " (halted)" : "");
+    }
+
+    world_destroy(w);
+    return 0;
+}
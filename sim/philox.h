@@ -0,0 +1,51 @@
+/**
+ * @file philox.h
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Counter-based random numbers (Philox4x32-10) for the simulated robots
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef __PHILOX_H__
+#define __PHILOX_H__
+
+#include <stdint.h>
+
+#define PHILOX_M0 0xD2511F53u  // round multipliers
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u  // key schedule (Weyl sequence)
+#define PHILOX_W1 0xBB67AE85u
+
+/**
+ * @brief Philox4x32-10 block: 128 random bits for a 128-bit counter and a 64-bit key.
+ *
+ * Unlike a generator with state, any draw can be computed directly from
+ * where it sits (run seed, robot, stream, index), so it does not matter
+ * which thread computes it or what other robots drew before.
+ *
+ * @param ctr (Counter, replaced by the random bits)
+ * @param key (Key)
+ */
+static inline void philox4x32(uint32_t ctr[4], const uint32_t key[2]) {
+    uint32_t k0 = key[0], k1 = key[1];
+    int i;
+
+    for (i = 0; i < 10; i++) {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * ctr[0];
+        uint64_t p1 = (uint64_t)PHILOX_M1 * ctr[2];
+        uint32_t c1 = ctr[1], c3 = ctr[3];
+
+        ctr[0] = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        ctr[1] = (uint32_t)p1;
+        ctr[2] = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        ctr[3] = (uint32_t)p0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+}
+
+#endif//__PHILOX_H__
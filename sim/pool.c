@@ -0,0 +1,249 @@
+/**
+ * @file pool.c
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Work-stealing thread pool for the data-parallel passes of the simulator
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "pool.h"
+
+#define POOL_SPIN 20000  // polls of an idle worker before it sleeps
+#define POOL_YIELD 64    // polls between two sched_yield(), for when there are more threads than cores
+
+#if defined(__x86_64__) || defined(__i386__)
+#define cpu_relax() __builtin_ia32_pause()
+#else
+#define cpu_relax() ((void)0)
+#endif
+
+/**
+ * @brief Backs off while polling a flag set by another worker
+ *
+ * @param spin (Number of polls so far)
+ */
+static inline void pool_pause(int spin) {
+    if (spin % POOL_YIELD == POOL_YIELD - 1)
+        sched_yield();
+    else
+        cpu_relax();
+}
+
+/**
+ * @brief Tasks left to a worker, packed as end << 32 | begin so that the
+ *        owner and thieves can both update them with one compare-and-swap.
+ */
+typedef struct {
+    _Atomic uint64_t range;
+    char pad[64 - sizeof(uint64_t)];  //  one queue per cache line
+} pool_queue_t;
+
+struct pool {
+    int n;                          //  number of workers
+    pthread_t *threads;             //  workers 1 to n-1
+    pool_queue_t *queues;           //  tasks of each worker
+    pool_fn_t fn;                   //  body of the current pass
+    void *arg;                      //  argument of the current pass
+    _Atomic uint32_t generation;    //  number of passes started
+    _Atomic int active;             //  workers 1 to n-1 still busy with the current pass
+    _Atomic int sleepers;           //  workers blocked on wake
+    _Atomic int stop;               //  set by pool_destroy()
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+};
+
+/**
+ * @brief Packs a task range
+ *
+ * @param begin (First task)
+ * @param end (One past the last task)
+ * @return uint64_t (Packed range)
+ */
+static inline uint64_t pool_range(uint32_t begin, uint32_t end) {
+    return (uint64_t)end << 32 | begin;
+}
+
+/**
+ * @brief Takes the lowest task of a worker's own range
+ *
+ * @param q (Queue of the worker)
+ * @return int (Task, or -1 if the range is empty)
+ */
+static int pool_take(pool_queue_t *q) {
+    uint64_t r = atomic_load(&q->range);
+
+    while (1) {
+        uint32_t begin = (uint32_t)r, end = (uint32_t)(r >> 32);
+        if (begin >= end)
+            return -1;
+        if (atomic_compare_exchange_weak(&q->range, &r, pool_range(begin + 1, end)))
+            return begin;
+    }
+}
+
+/**
+ * @brief Moves the upper half of another worker's range into an empty queue
+ *
+ * @param p (Pool)
+ * @param self (Worker doing the stealing)
+ * @return int (Non-zero if some tasks were stolen)
+ */
+static int pool_steal(pool_t *p, int self) {
+    int k;
+
+    for (k = 1; k < p->n; k++) {
+        pool_queue_t *victim = &p->queues[(self + k) % p->n];
+        uint64_t r = atomic_load(&victim->range);
+        while (1) {
+            uint32_t begin = (uint32_t)r, end = (uint32_t)(r >> 32), mid;
+            if (begin >= end)
+                break;
+            mid = end - (end - begin + 1) / 2;
+            if (atomic_compare_exchange_weak(&victim->range, &r, pool_range(begin, mid))) {
+                atomic_store(&p->queues[self].range, pool_range(mid, end));
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Runs tasks of the current pass until none is left anywhere
+ *
+ * @param p (Pool)
+ * @param self (Worker)
+ */
+static void pool_work(pool_t *p, int self) {
+    while (1) {
+        int task = pool_take(&p->queues[self]);
+        if (task < 0) {
+            if (!pool_steal(p, self))
+                return;
+            continue;
+        }
+        p->fn(p->arg, task, self);
+    }
+}
+
+/**
+ * @brief Worker thread: waits for each pass, helps with it, and reports back
+ *
+ * @param arg (Array of the pool and the worker number, freed here)
+ * @return void* (Unused)
+ */
+static void *pool_thread(void *arg) {
+    pool_t *p = ((void **)arg)[0];
+    int self = (int)(intptr_t)((void **)arg)[1];
+    uint32_t seen = 0;
+
+    free(arg);
+    while (1) {
+        int spin;
+        for (spin = 0; spin < POOL_SPIN && atomic_load(&p->generation) == seen && !atomic_load(&p->stop); spin++)
+            pool_pause(spin);
+        if (atomic_load(&p->generation) == seen && !atomic_load(&p->stop)) {
+            pthread_mutex_lock(&p->lock);
+            atomic_fetch_add(&p->sleepers, 1);
+            while (atomic_load(&p->generation) == seen && !atomic_load(&p->stop))
+                pthread_cond_wait(&p->wake, &p->lock);
+            atomic_fetch_sub(&p->sleepers, 1);
+            pthread_mutex_unlock(&p->lock);
+        }
+        if (atomic_load(&p->stop))
+            return NULL;
+        seen++;
+        pool_work(p, self);
+        atomic_fetch_sub(&p->active, 1);
+    }
+}
+
+pool_t *pool_create(int workers) {
+    pool_t *p = calloc(1, sizeof(pool_t));
+    int i;
+
+    if (!p)
+        return NULL;
+    p->n = workers < 1 ? 1 : workers;
+    p->threads = calloc(p->n, sizeof(pthread_t));
+    if (!p->threads || posix_memalign((void **)&p->queues, 64, p->n * sizeof(pool_queue_t))) {
+        free(p->threads);
+        free(p);
+        return NULL;
+    }
+    for (i = 0; i < p->n; i++)
+        atomic_init(&p->queues[i].range, 0);
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->wake, NULL);
+    for (i = 1; i < p->n; i++) {
+        void **arg = malloc(2 * sizeof(void *));
+        if (!arg)
+            break;
+        arg[0] = p;
+        arg[1] = (void *)(intptr_t)i;
+        if (pthread_create(&p->threads[i], NULL, pool_thread, arg)) {
+            free(arg);
+            break;
+        }
+    }
+    if (i < p->n) {
+        p->n = i;  // stop the workers that did start
+        pool_destroy(p);
+        return NULL;
+    }
+    return p;
+}
+
+int pool_workers(const pool_t *p) {
+    return p ? p->n : 1;
+}
+
+void pool_run(pool_t *p, int tasks, pool_fn_t fn, void *arg) {
+    int i, spin;
+
+    if (!p || p->n == 1 || tasks <= 1) {
+        for (i = 0; i < tasks; i++)
+            fn(arg, i, 0);
+        return;
+    }
+    p->fn = fn;
+    p->arg = arg;
+    for (i = 0; i < p->n; i++)
+        atomic_store(&p->queues[i].range, pool_range((int64_t)tasks * i / p->n, (int64_t)tasks * (i + 1) / p->n));
+    atomic_store(&p->active, p->n - 1);
+    atomic_fetch_add(&p->generation, 1);
+    if (atomic_load(&p->sleepers)) {
+        pthread_mutex_lock(&p->lock);
+        pthread_cond_broadcast(&p->wake);
+        pthread_mutex_unlock(&p->lock);
+    }
+    pool_work(p, 0);
+    for (spin = 0; atomic_load(&p->active); spin++)
+        pool_pause(spin);
+}
+
+void pool_destroy(pool_t *p) {
+    int i;
+
+    atomic_store(&p->stop, 1);
+    pthread_mutex_lock(&p->lock);
+    pthread_cond_broadcast(&p->wake);
+    pthread_mutex_unlock(&p->lock);
+    for (i = 1; i < p->n; i++)
+        pthread_join(p->threads[i], NULL);
+    pthread_mutex_destroy(&p->lock);
+    pthread_cond_destroy(&p->wake);
+    free(p->queues);
+    free(p->threads);
+    free(p);
+}
@@ -0,0 +1,70 @@
+/**
+ * @file pool.h
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Work-stealing thread pool for the data-parallel passes of the simulator
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef __POOL_H__
+#define __POOL_H__
+
+/**
+ * @brief Body of a parallel pass, called once per task.
+ *
+ * @param arg (Argument given to pool_run())
+ * @param task (Task number, 0 to tasks-1)
+ * @param worker (Worker running the task, 0 to pool_workers()-1)
+ */
+typedef void (*pool_fn_t)(void *arg, int task, int worker);
+
+/**
+ * @brief A set of worker threads, the calling thread being worker 0.
+ *
+ * pool_run() deals the tasks out in contiguous ranges, one per worker; a
+ * worker that runs out steals the upper half of another worker's range, so
+ * that uneven tasks (crowded grid cells) still keep every core busy.
+ */
+typedef struct pool pool_t;
+
+/**
+ * @brief Start a pool.
+ *
+ * @param workers (Number of workers, the calling thread included)
+ * @return pool_t* (New pool, or NULL on failure)
+ */
+pool_t *pool_create(int workers);
+
+/**
+ * @brief Number of workers of a pool.
+ *
+ * @param p (Pool, or NULL for the calling thread alone)
+ * @return int (Number of workers)
+ */
+int pool_workers(const pool_t *p);
+
+/**
+ * @brief Run @p fn on tasks 0 to @p tasks-1 and wait for all of them.
+ *
+ * Tasks run in no particular order and concurrently, so they must only
+ * write to memory that belongs to their task or to their worker.
+ *
+ * @param p (Pool, or NULL to run every task on the calling thread)
+ * @param tasks (Number of tasks)
+ * @param fn (Task body)
+ * @param arg (Argument passed to @p fn)
+ */
+void pool_run(pool_t *p, int tasks, pool_fn_t fn, void *arg);
+
+/**
+ * @brief Stop the workers and free the pool.
+ *
+ * @param p (Pool)
+ */
+void pool_destroy(pool_t *p);
+
+#endif//__POOL_H__
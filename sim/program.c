@@ -0,0 +1,37 @@
+/**
+ * @file program.c
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Template compiled once per linked program to describe it to the simulator
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Compile with -DPROGRAM=<name> -DROLE=<planet|seed>.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "program.h"
+
+#define STR_(x) #x
+#define STR(x) STR_(x)
+#define CAT_(a, b) a##b
+#define CAT(a, b) CAT_(a, b)
+
+extern int CAT(PROGRAM, _main)(void);
+
+//  defined by the linker around the program's renamed sections, if it has them
+extern char CAT(__start_kilobot_data_, PROGRAM)[] __attribute__((weak));
+extern char CAT(__stop_kilobot_data_, PROGRAM)[] __attribute__((weak));
+extern char CAT(__start_kilobot_bss_, PROGRAM)[] __attribute__((weak));
+extern char CAT(__stop_kilobot_bss_, PROGRAM)[] __attribute__((weak));
+
+const kilobot_program_t CAT(kilobot_program_, ROLE) = {
+    STR(PROGRAM),
+    CAT(PROGRAM, _main),
+    CAT(__start_kilobot_data_, PROGRAM),
+    CAT(__stop_kilobot_data_, PROGRAM),
+    CAT(__start_kilobot_bss_, PROGRAM),
+    CAT(__stop_kilobot_bss_, PROGRAM),
+};
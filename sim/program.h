@@ -0,0 +1,41 @@
+/**
+ * @file program.h
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Descriptor of a kilobot program linked into the simulator
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef __PROGRAM_H__
+#define __PROGRAM_H__
+
+/**
+ * @brief A kilobot program linked into the simulator.
+ *
+ * The host build compiles each program with `-Dmain=<name>_main` and then
+ * hides every symbol of the object except that entry point, so that a seed
+ * program and a planet program can be linked into the same simulator.
+ *
+ * It also moves the program's .data and .bss to sections of their own,
+ * `kilobot_data_<name>` and `kilobot_bss_<name>`. Every file-scope and
+ * static variable of the program lives there, `g` included, so the
+ * simulator gives each robot its own copy by swapping those two ranges
+ * when it switches robots.
+ */
+typedef struct {
+    const char *name;       //  file name of the program, without extension
+    int (*main)(void);      //  the program's main()
+    char *data_start;       //  initialized variables of the program (NULL if none)
+    char *data_end;
+    char *bss_start;        //  zero-initialized variables of the program (NULL if none)
+    char *bss_end;
+} kilobot_program_t;
+
+extern const kilobot_program_t kilobot_program_planet;  //  program run by every robot
+extern const kilobot_program_t kilobot_program_seed __attribute__((weak));  //  optional program of robot 0
+
+#endif//__PROGRAM_H__
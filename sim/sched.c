@@ -0,0 +1,241 @@
+/**
+ * @file sched.c
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Event queue ordering the robots by the time of their next event
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdlib.h>
+
+#include "sched.h"
+
+/**
+ * @brief Level of the wheel for a time differing from the current time in the bits of @p d
+ *
+ * @param d (Time xor current time)
+ * @return int (Level)
+ */
+static inline int sched_level(uint64_t d) {
+    return d ? (63 - __builtin_clzll(d)) / SCHED_BITS : 0;
+}
+
+/**
+ * @brief Puts robot @p id in the slot matching its time
+ *
+ * @param s (Queue)
+ * @param id (Robot, out of the wheel, at a time other than UINT64_MAX)
+ */
+static void sched_link(sched_t *s, int id) {
+    uint64_t t = s->time[id] < s->now ? s->now : s->time[id];
+    int level = sched_level(t ^ s->now);
+    int slot = (int)(t >> (level * SCHED_BITS)) & (SCHED_SLOTS - 1);
+    int b = level * SCHED_SLOTS + slot;
+    int after = s->tail[b];
+
+    //  the lowest level holds a single time per slot, sorted by id once it is due
+    if (level == 0 && after > id)
+        s->unsorted |= 1ULL << slot;
+    s->prev[id] = after;
+    s->next[id] = -1;
+    if (after >= 0)
+        s->next[after] = id;
+    else
+        s->head[b] = id;
+    s->tail[b] = id;
+    s->slot[id] = b;
+    s->occupied[level] |= 1ULL << slot;
+}
+
+/**
+ * @brief Takes robot @p id out of its slot
+ *
+ * @param s (Queue)
+ * @param id (Robot, in the wheel)
+ */
+static void sched_unlink(sched_t *s, int id) {
+    int b = s->slot[id];
+
+    if (s->prev[id] >= 0)
+        s->next[s->prev[id]] = s->next[id];
+    else
+        s->head[b] = s->next[id];
+    if (s->next[id] >= 0)
+        s->prev[s->next[id]] = s->prev[id];
+    else
+        s->tail[b] = s->prev[id];
+    if (s->head[b] < 0)
+        s->occupied[b / SCHED_SLOTS] &= ~(1ULL << (b % SCHED_SLOTS));
+    s->slot[id] = -1;
+}
+
+/**
+ * @brief Sorts a list of robots by id (merge sort)
+ *
+ * @param next (Links of the robots; only next is used and updated)
+ * @param head (First robot of the list, -1 if empty)
+ * @return int32_t (First robot of the sorted list)
+ */
+static int32_t sched_sort_ids(int32_t *next, int32_t head) {
+    int32_t a, b, slow, fast, merged, *tail = &merged;
+
+    if (head < 0 || next[head] < 0)
+        return head;
+    slow = head;
+    fast = next[head];
+    while (fast >= 0 && next[fast] >= 0) {
+        slow = next[slow];
+        fast = next[next[fast]];
+    }
+    b = next[slow];
+    next[slow] = -1;
+    a = sched_sort_ids(next, head);
+    b = sched_sort_ids(next, b);
+    while (a >= 0 && b >= 0) {
+        if (a < b) {
+            *tail = a;
+            tail = &next[a];
+            a = next[a];
+        } else {
+            *tail = b;
+            tail = &next[b];
+            b = next[b];
+        }
+    }
+    *tail = a >= 0 ? a : b;
+    return merged;
+}
+
+/**
+ * @brief Puts the robots of a slot of the lowest level in id order
+ *
+ * @param s (Queue)
+ * @param slot (Slot of level 0)
+ */
+static void sched_sort(sched_t *s, int slot) {
+    int32_t id, prev = -1;
+
+    s->head[slot] = sched_sort_ids(s->next, s->head[slot]);
+    for (id = s->head[slot]; id >= 0; id = s->next[id]) {
+        s->prev[id] = prev;
+        prev = id;
+    }
+    s->tail[slot] = prev;
+    s->unsorted &= ~(1ULL << slot);
+}
+
+/**
+ * @brief Moves the current time to @p now and cascades the slot it enters
+ *
+ * Only the slot of the highest level whose bits change holds entries that
+ * now belong lower: the levels below are empty, as none of their entries
+ * could be earlier than @p now.
+ *
+ * @param s (Queue)
+ * @param now (New current time, not after any entry)
+ */
+static void sched_move(sched_t *s, uint64_t now) {
+    int level, b, id;
+
+    if (now == s->now)
+        return;
+    level = sched_level(now ^ s->now);
+    b = level * SCHED_SLOTS + ((int)(now >> (level * SCHED_BITS)) & (SCHED_SLOTS - 1));
+    id = s->head[b];
+    s->now = now;
+    s->head[b] = s->tail[b] = -1;
+    s->occupied[level] &= ~(1ULL << (b % SCHED_SLOTS));
+    while (id >= 0) {
+        int next = s->next[id];
+        sched_link(s, id);
+        id = next;
+    }
+}
+
+void sched_init(sched_t *s) {
+    int i;
+
+    s->now = 0;
+    s->unsorted = 0;
+    for (i = 0; i < SCHED_LEVELS; i++)
+        s->occupied[i] = 0;
+    for (i = 0; i < SCHED_LEVELS * SCHED_SLOTS; i++)
+        s->head[i] = s->tail[i] = -1;
+    s->next = s->prev = NULL;
+    s->slot = NULL;
+    s->time = NULL;
+    s->n = s->capacity = 0;
+}
+
+void sched_free(sched_t *s) {
+    free(s->next);
+    free(s->prev);
+    free(s->slot);
+    free(s->time);
+    sched_init(s);
+}
+
+int sched_add(sched_t *s, uint64_t time) {
+    int id = s->n;
+
+    if (s->n == s->capacity) {
+        int capacity = s->capacity ? 2*s->capacity : 64;
+        int32_t *next = realloc(s->next, capacity * sizeof(int32_t));
+        int32_t *prev = next ? realloc(s->prev, capacity * sizeof(int32_t)) : NULL;
+        int16_t *slot = prev ? realloc(s->slot, capacity * sizeof(int16_t)) : NULL;
+        uint64_t *t = slot ? realloc(s->time, capacity * sizeof(uint64_t)) : NULL;
+        if (next)
+            s->next = next;
+        if (prev)
+            s->prev = prev;
+        if (slot)
+            s->slot = slot;
+        if (!t)
+            return -1;
+        s->time = t;
+        s->capacity = capacity;
+    }
+    s->n++;
+    s->time[id] = time;
+    s->slot[id] = -1;
+    if (time != UINT64_MAX)
+        sched_link(s, id);
+    return id;
+}
+
+void sched_update(sched_t *s, int id, uint64_t time) {
+    if (s->slot[id] >= 0)
+        sched_unlink(s, id);
+    s->time[id] = time;
+    if (time != UINT64_MAX)
+        sched_link(s, id);
+}
+
+uint64_t sched_advance(sched_t *s, uint64_t limit) {
+    while (1) {
+        int level = 0, slot, shift;
+        uint64_t start;
+
+        while (level < SCHED_LEVELS && !s->occupied[level])
+            level++;
+        if (level == SCHED_LEVELS)
+            return UINT64_MAX;
+        slot = __builtin_ctzll(s->occupied[level]);
+        shift = level * SCHED_BITS;
+        //  start of the earliest slot: the earliest event is there, at this very time on the lowest level
+        start = shift + SCHED_BITS < 64 ? s->now & ~((1ULL << (shift + SCHED_BITS)) - 1) : 0;
+        start |= (uint64_t)slot << shift;
+        if (level == 0) {
+            if (s->unsorted >> slot & 1)
+                sched_sort(s, slot);
+            return start;
+        }
+        if (start > limit)
+            return start;
+        sched_move(s, start);
+    }
+}
@@ -0,0 +1,104 @@
+/**
+ * @file sched.h
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Event queue ordering the robots by the time of their next event
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef __SCHED_H__
+#define __SCHED_H__
+
+#include <stdint.h>
+
+#define SCHED_BITS   6                          // bits of time covered by one level of the wheel
+#define SCHED_SLOTS  (1 << SCHED_BITS)          // slots of each level
+#define SCHED_LEVELS ((64 + SCHED_BITS - 1) / SCHED_BITS)  // levels covering the whole 64-bit time
+
+/**
+ * @brief Hierarchical timing wheel holding one entry per robot.
+ *
+ * An entry lives at the level of the highest bit in which its time differs
+ * from the wheel's current time, in the slot given by its time bits at that
+ * level. Inserting and removing are O(1); when the current time reaches a
+ * slot of an upper level, its entries cascade to the levels below, so each
+ * entry moves at most SCHED_LEVELS times before it expires.
+ *
+ * Entries are ordered by time, then by robot id so that robots due at the
+ * same cycle always run in the same order: the lowest level has one slot per
+ * cycle, appended to like the others, and sched_advance() sorts the slot it
+ * returns by id if robots were added to it out of order. Robots at time UINT64_MAX have
+ * nothing to do and stay out of the wheel until their next sched_update().
+ */
+typedef struct {
+    uint64_t now;                                   //  current time: no entry is earlier
+    uint64_t occupied[SCHED_LEVELS];                //  non-empty slots of each level, one bit per slot
+    uint64_t unsorted;                              //  slots of the lowest level that may be out of id order
+    int32_t head[SCHED_LEVELS * SCHED_SLOTS];       //  first robot of each slot (-1 if empty)
+    int32_t tail[SCHED_LEVELS * SCHED_SLOTS];       //  last robot of each slot
+    int32_t *next, *prev;                           //  links of each robot within its slot
+    int16_t *slot;                                  //  slot of each robot (level * SCHED_SLOTS + slot, -1 if out of the wheel)
+    uint64_t *time;                                 //  key of each robot
+    int n;                                          //  number of robots
+    int capacity;                                   //  allocated size of the arrays
+} sched_t;
+
+/**
+ * @brief Initialize an empty queue.
+ *
+ * @param s (Queue)
+ */
+void sched_init(sched_t *s);
+
+/**
+ * @brief Release the memory of a queue.
+ *
+ * @param s (Queue)
+ */
+void sched_free(sched_t *s);
+
+/**
+ * @brief Add the next robot (ids are given out in order 0, 1, 2...).
+ *
+ * @param s (Queue)
+ * @param time (Time of the robot's first event, not before the current time)
+ * @return int (Id of the robot, or -1 on allocation failure)
+ */
+int sched_add(sched_t *s, uint64_t time);
+
+/**
+ * @brief Move the event of robot @p id to @p time.
+ *
+ * @param s (Queue)
+ * @param id (Robot)
+ * @param time (New time of its next event, not before the current time)
+ */
+void sched_update(sched_t *s, int id, uint64_t time);
+
+/**
+ * @brief Advance the wheel towards its earliest event, without going past @p limit.
+ *
+ * Afterwards the current time is at most @p limit, so events may still be
+ * scheduled at any time from @p limit on.
+ *
+ * @param s (Queue)
+ * @param limit (Latest time the caller is about to reach)
+ * @return uint64_t (Time of the earliest event if it is at most @p limit, otherwise some time after @p limit)
+ */
+uint64_t sched_advance(sched_t *s, uint64_t limit);
+
+/**
+ * @brief Robot with the earliest event.
+ *
+ * @param s (Queue, after sched_advance() returned the time of that event)
+ * @return int (Robot id)
+ */
+static inline int sched_first(const sched_t *s) {
+    return s->head[__builtin_ctzll(s->occupied[0])];
+}
+
+#endif//__SCHED_H__
@@ -0,0 +1,159 @@
+#!/bin/sh
+#
+# @file sweep.sh
+# @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+#
+# @brief Runs a program over every combination of values of its #defines, times several placements,
+#        on all cores, and gathers the formation metrics of every run (see analyze.c) in one table
+# @version 0.1
+# @date 2026-10-17
+#
+# @copyright Copyright (c) 2026
+#
+# sim/sweep.sh -f duos_circle1.c -k 16 DESIRED_DISTANCE=45,55,65 EPSILON=10,15,20 SILENT_TICKS=160,320
+#
+# Each combination is built once (make host with HOST_DEFINES, in a directory of its own), then
+# every (combination, placement) pair runs as a single-threaded process, as many at a time as there
+# are cores. Placement k is run seed k for every combination, so they all start from the same layouts.
+# The table, OUT/results.tsv, has one row per run, indexed by combination and placement.
+
+set -e
+
+usage() {
+    cat >&2 <<EOF
+usage: $0 [-f file.c] [-S seed.c] [-n robots] [-t seconds] [-k placements] [-j jobs] [-o dir] NAME=value,value... ...
+  NAME=values    #define of the program and the values to try, e.g. EPSILON=10,15,20
+  -f file.c      program of the robots (default singles_circle1.c)
+  -S seed.c      program of robot 0 (default seed.c, '' for none)
+  -n robots      robots, seed included (default 16)
+  -t seconds     simulated time of each run (default 900)
+  -k placements  random placements of each combination (default 8)
+  -j jobs        runs at a time (default: one per core)
+  -o dir         where builds, traces and results.tsv go (default sweep)
+EOF
+    exit 2
+}
+
+file=singles_circle1.c
+seed=seed.c
+robots=16
+seconds=900
+placements=8
+jobs=$(getconf _NPROCESSORS_ONLN)
+out=sweep
+while getopts f:S:n:t:k:j:o:h opt; do
+    case $opt in
+    f) file=$OPTARG ;;
+    S) seed=$OPTARG ;;
+    n) robots=$OPTARG ;;
+    t) seconds=$OPTARG ;;
+    k) placements=$OPTARG ;;
+    j) jobs=$OPTARG ;;
+    o) out=$OPTARG ;;
+    *) usage ;;
+    esac
+done
+shift $((OPTIND - 1))
+for p in "$@"; do
+    case $p in
+    [A-Za-z_]*=?*) ;;
+    *) usage ;;
+    esac
+done
+
+# make works from the top of the repository
+case $out in
+/*) ;;
+*) out=$PWD/$out ;;
+esac
+cd "$(dirname "$0")/.."
+name=${file%.c}
+source=$(find src -name "$file" -print -quit)
+[ -n "$source" ] || { echo "$0: $file not found in src" >&2; exit 1; }
+mkdir -p "$out/build" "$out/bin" "$out/runs"
+
+# the grid, one combination per line of OUT/configs ("NAME=value NAME=value ...")
+: > "$out/configs"
+echo > "$out/configs.next"
+for p in "$@"; do
+    while IFS= read -r line; do
+        for v in $(echo "${p#*=}" | tr ',' ' '); do
+            echo "${line:+$line }${p%%=*}=$v"
+        done
+    done < "$out/configs.next" > "$out/configs"
+    cp "$out/configs" "$out/configs.next"
+done
+[ $# -gt 0 ] || echo > "$out/configs"
+rm -f "$out/configs.next"
+configs=$(wc -l < "$out/configs")
+
+# value of a #define in combination $1: the swept one, else the program's own
+define() {
+    v=$(sed -n "$(($1 + 1))p" "$out/configs" | tr ' ' '\n' | sed -n "s/^$2=//p")
+    [ -n "$v" ] || v=$(sed -n "s/^#define[ \t]*$2[ \t]*\([0-9]*\).*/\1/p" "$source" | head -n 1)
+    echo "$v"
+}
+
+# builds: the first one alone, as it also builds the simulator and kilolib they share
+build() {
+    defines=$(sed -n "$(($1 + 1))p" "$out/configs" | sed 's/\([^ ][^ ]*\)/-D\1/g')
+    make -s host FILENAME="$file" ${seed:+SEED="$seed"} HOST_DEFINES="-DNUMBER_OF_ROBOTS=256 $defines" \
+         HOST_OUT="$out/build/c$1" HOST_BIN="$out/bin/c$1"
+}
+echo "building $configs combination(s) of $name"
+make -s analyze
+build 0
+i=1
+while [ $i -lt "$configs" ]; do
+    build $i &
+    if [ $((i % jobs)) -eq 0 ]; then
+        wait
+    fi
+    i=$((i + 1))
+done
+wait
+
+echo "running $((configs * placements)) simulations of $robots robots for $seconds s, $jobs at a time"
+i=0
+while [ $i -lt "$configs" ]; do
+    k=1
+    while [ $k -le "$placements" ]; do
+        echo $i $k
+        k=$((k + 1))
+    done
+    i=$((i + 1))
+done | xargs -n 2 -P "$jobs" sh -c \
+    '"$1/bin/c$4" -n "$2" -t "$3" -s "$5" -j 1 -o "$1/runs/c$4-s$5" > "$1/runs/c$4-s$5.log"' run "$out" "$robots" "$seconds"
+
+# the table: combination, its values, placement, then the columns of bin/analyze
+{
+    printf 'config'
+    for p in "$@"; do
+        printf '\t%s' "${p%%=*}"
+    done
+    printf '\tplacement\trobots\ttime\tformed\tring\tradius_var\tgap_cv\tmotor\tloss\n'
+    i=0
+    while [ $i -lt "$configs" ]; do
+        values=$(sed -n "$((i + 1))p" "$out/configs" | sed 's/[^ =]*=//g')
+        runs=
+        k=1
+        while [ $k -le "$placements" ]; do
+            runs="$runs $out/runs/c$i-s$k"
+            k=$((k + 1))
+        done
+        bin/analyze -j "$jobs" -c "$(define $i ROBOTS_IN_FIRST_CIRCLE)" -d "$(define $i DESIRED_DISTANCE)" \
+                    -e "$(define $i EPSILON)" $runs |
+            awk -v config=$i -v values="$values" 'NR > 1 {
+                printf "%s", config
+                n = split(values, v, " ")
+                for (j = 1; j <= n; j++)
+                    printf "\t%s", v[j]
+                printf "\t%d", NR - 1
+                for (j = 2; j <= NF; j++)
+                    printf "\t%s", $j
+                printf "\n"
+            }'
+        i=$((i + 1))
+    done
+} > "$out/results.tsv"
+echo "results in $out/results.tsv"
@@ -0,0 +1,165 @@
+/**
+ * @file task.c
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Tasks implemented as stackful coroutines switched in user space
+ * @version 0.2
+ * @date 2026-10-17
+ *
+ * On x86-64 a task switch saves the callee-saved registers on the task's own
+ * stack and swaps stack pointers, which costs a few nanoseconds. Other
+ * architectures (or a build with -DTASK_UCONTEXT) fall back to
+ * swapcontext(), which is slower because it also saves the signal mask.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "task.h"
+
+#if defined(__x86_64__) && !defined(TASK_UCONTEXT)
+#define TASK_ASM
+#define TASK_MXCSR  0x1F80UL    // all exceptions masked, round to nearest
+#define TASK_X87_CW 0x037FUL    // the same for the x87, extended precision
+#else
+#include <ucontext.h>
+#endif
+
+struct task {
+    void *stack;            //  base of the task's stack
+    void (*fn)(void *);     //  task body
+    void *arg;              //  argument of the task body
+#ifdef TASK_ASM
+    void *sp;               //  saved stack pointer while the task is suspended
+#else
+    ucontext_t context;     //  saved context while the task is suspended
+#endif
+};
+
+static task_t *task_self;   //  task currently running, NULL in the scheduler
+#ifdef TASK_ASM
+static void *scheduler_sp;  //  saved stack pointer of the scheduler
+#else
+static ucontext_t scheduler_context;
+#endif
+
+/**
+ * @brief Runs the body of the current task
+ *
+ * Tasks must never return; should the body do so anyway, the task stays
+ * parked forever instead of running off its stack.
+ */
+static void task_entry(void) {
+    task_self->fn(task_self->arg);
+    while (1)
+        task_yield();
+}
+
+#ifdef TASK_ASM
+/**
+ * @brief Saves the callee-saved registers and stack pointer into @p save, then resumes @p load
+ *
+ * The callee-saved registers include the control bits of MXCSR and the x87
+ * control word (rounding, exception masks), so that a task changing them
+ * with fesetround() and the like does not change them for the others.
+ *
+ * @param save (Receives the stack pointer of the caller)
+ * @param load (Stack pointer saved by an earlier task_switch() or prepared by task_create())
+ */
+void task_switch(void **save, void *load) __attribute__((visibility("hidden")));
+
+__asm__(
+    ".text\n"
+    ".globl task_switch\n"
+    ".hidden task_switch\n"
+    ".type task_switch, @function\n"
+    "task_switch:\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $8, %rsp\n"
+    "    stmxcsr (%rsp)\n"
+    "    fnstcw 4(%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    ldmxcsr (%rsp)\n"
+    "    fldcw 4(%rsp)\n"
+    "    addq $8, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".size task_switch, .-task_switch\n"
+);
+#endif
+
+task_t *task_create(void (*fn)(void *), void *arg, size_t stack_size) {
+    task_t *t = malloc(sizeof(task_t));
+    if (!t)
+        return NULL;
+    //  stacks are only touched as deep as the program goes: most of this is never paged in
+    t->stack = malloc(stack_size);
+    if (!t->stack) {
+        free(t);
+        return NULL;
+    }
+    t->fn = fn;
+    t->arg = arg;
+#ifdef TASK_ASM
+    {
+        //  frame popped by the first task_switch(): MXCSR and the x87 control
+        //  word at their power-on values, six registers, then the return
+        //  address task_entry, whose own return address is a null guard
+        uintptr_t top = ((uintptr_t)t->stack + stack_size) & ~(uintptr_t)15;
+        void **sp = (void **)top;
+        *--sp = NULL;
+        *--sp = (void *)task_entry;
+        sp -= 6;
+        for (int i = 0; i < 6; i++)
+            sp[i] = NULL;
+        *--sp = (void *)(TASK_MXCSR | TASK_X87_CW << 32);
+        t->sp = sp;
+    }
+#else
+    getcontext(&t->context);
+    t->context.uc_stack.ss_sp = t->stack;
+    t->context.uc_stack.ss_size = stack_size;
+    t->context.uc_link = NULL;
+    makecontext(&t->context, task_entry, 0);
+#endif
+    return t;
+}
+
+void task_resume(task_t *t) {
+    task_self = t;
+#ifdef TASK_ASM
+    task_switch(&scheduler_sp, t->sp);
+#else
+    swapcontext(&scheduler_context, &t->context);
+#endif
+    task_self = NULL;
+}
+
+void task_yield(void) {
+    task_t *t = task_self;
+#ifdef TASK_ASM
+    task_switch(&t->sp, scheduler_sp);
+#else
+    swapcontext(&t->context, &scheduler_context);
+#endif
+}
+
+void task_destroy(task_t *t) {
+    //  a suspended task holds no resources besides its stack
+    free(t->stack);
+    free(t);
+}
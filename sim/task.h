@@ -0,0 +1,55 @@
+/**
+ * @file task.h
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Execution contexts that let every simulated robot block in delay()
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef __TASK_H__
+#define __TASK_H__
+
+#include <stddef.h>
+
+/**
+ * @brief One robot's flow of control.
+ *
+ * Tasks never run concurrently: the scheduler resumes one task, which runs
+ * until it calls task_yield(), and only then does task_resume() return.
+ */
+typedef struct task task_t;
+
+/**
+ * @brief Create a suspended task that will run @p fn(@p arg) on its first resume.
+ *
+ * @param fn (Task body; it must never return)
+ * @param arg (Argument passed to @p fn)
+ * @param stack_size (Stack size in bytes)
+ * @return task_t* (New task, or NULL on failure)
+ */
+task_t *task_create(void (*fn)(void *), void *arg, size_t stack_size);
+
+/**
+ * @brief Run @p t until it yields. Must be called from the scheduler.
+ *
+ * @param t (Task to run)
+ */
+void task_resume(task_t *t);
+
+/**
+ * @brief Return control to the scheduler. Must be called from inside a task.
+ */
+void task_yield(void);
+
+/**
+ * @brief Release a suspended task.
+ *
+ * @param t (Task to destroy)
+ */
+void task_destroy(task_t *t);
+
+#endif//__TASK_H__
@@ -0,0 +1,115 @@
+/**
+ * @file task_check.c
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Checks that the floating point rounding mode set by one task stays with that task
+ *
+ * The scheduler and two tasks each set a different rounding mode, then
+ * switch back and forth: each must find its own mode again, in MXCSR (SSE)
+ * and in the x87 control word alike, whichever way task.c switches (its
+ * x86-64 assembly, or swapcontext() when built with -DTASK_UCONTEXT).
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <fenv.h>
+#include <stdio.h>
+
+#include "task.h"
+
+#define ROUNDS 4    // times each side switches away and back
+
+static int failed;
+
+/**
+ * @brief Name of a rounding mode
+ *
+ * @param mode (FE_TONEAREST, FE_UPWARD, FE_DOWNWARD or FE_TOWARDZERO)
+ * @return const char* (Name)
+ */
+static const char *mode_name(int mode) {
+    return mode == FE_TONEAREST ? "to nearest" : mode == FE_UPWARD ? "upward" :
+           mode == FE_DOWNWARD ? "downward" : mode == FE_TOWARDZERO ? "toward zero" : "unknown";
+}
+
+/**
+ * @brief Checks that both floating point units round in @p mode
+ *
+ * fegetround() only reads one of them, so each is checked by divisions
+ * whose results tell the four modes apart: 1/3 and -1/3, in double (SSE)
+ * and in long double (x87), against the same divisions rounded in @p mode.
+ *
+ * @param who (Side checking, for the message)
+ * @param mode (Rounding mode it set)
+ */
+static void check(const char *who, int mode) {
+    //  volatile, and -1 of its own: the compiler would turn -1/3 into -(1/3)
+    volatile double one = 1, minus_one = -1, three = 3;
+    volatile long double one_x87 = 1, minus_one_x87 = -1, three_x87 = 3;
+    double sse[2] = {one / three, minus_one / three}, expected[2];
+    long double x87[2] = {one_x87 / three_x87, minus_one_x87 / three_x87}, expected_x87[2];
+    int m = fegetround(), sse_ok, x87_ok;
+
+    //  the same divisions in mode, then back to whatever mode this side had
+    fesetround(mode);
+    expected[0] = one / three;
+    expected[1] = minus_one / three;
+    expected_x87[0] = one_x87 / three_x87;
+    expected_x87[1] = minus_one_x87 / three_x87;
+    fesetround(m);
+    sse_ok = sse[0] == expected[0] && sse[1] == expected[1];
+    x87_ok = x87[0] == expected_x87[0] && x87[1] == expected_x87[1];
+    if (m != mode || !sse_ok || !x87_ok) {
+        printf("%s: rounds %s (SSE %s, x87 %s), set %s\n", who, mode_name(m),
+               sse_ok ? "as set" : "not as set", x87_ok ? "as set" : "not as set", mode_name(mode));
+        failed = 1;
+    }
+}
+
+/**
+ * @brief Sets its own rounding mode, then checks it after every switch
+ *
+ * @param arg (Rounding mode of the task)
+ */
+static void body(void *arg) {
+    int mode = *(int *)arg, i;
+
+    fesetround(mode);
+    for (i = 0; i < ROUNDS; i++) {
+        task_yield();
+        check("task", mode);
+    }
+    while (1)
+        task_yield();
+}
+
+int main(void) {
+    int up = FE_UPWARD, down = FE_DOWNWARD, i;
+    task_t *a = task_create(body, &up, 64*1024);
+    task_t *b = task_create(body, &down, 64*1024);
+
+    if (!a || !b) {
+        fprintf(stderr, "task_check: out of memory\n");
+        return 1;
+    }
+    fesetround(FE_TOWARDZERO);
+    for (i = 0; i <= ROUNDS; i++) {
+        task_resume(a);
+        check("scheduler", FE_TOWARDZERO);
+        task_resume(b);
+        check("scheduler", FE_TOWARDZERO);
+    }
+    fesetround(FE_TONEAREST);
+    task_destroy(a);
+    task_destroy(b);
+#ifdef TASK_UCONTEXT
+    printf("swapcontext() switches: %s\n", failed ? "rounding modes leak between tasks" : "every task keeps its rounding mode");
+#else
+    printf("task_switch() switches: %s\n", failed ? "rounding modes leak between tasks" : "every task keeps its rounding mode");
+#endif
+    return failed;
+}
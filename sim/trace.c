@@ -0,0 +1,280 @@
+/**
+ * @file trace.c
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Binary trace of a simulation run: robot state every kilo tick and message events
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../kilolib/kilolib_host.h"
+#include "trace.h"
+
+struct trace {
+    FILE *samples;                  //  NAME.ktrace
+    FILE *events;                   //  NAME.kevents
+    trace_header_t header;          //  header of NAME.ktrace, ticks counting the samples written
+    trace_events_header_t events_header;  //  header of NAME.kevents
+    uint8_t *chunk;                 //  chunk being filled
+    uint32_t sampled;               //  samples taken, including those of the chunk being filled
+    int error;                      //  a write failed
+};
+
+/**
+ * @brief Opens NAME plus an extension for writing
+ *
+ * @param name (Path without the extension)
+ * @param ext (Extension)
+ * @return FILE* (File, or NULL on failure)
+ */
+static FILE *trace_file(const char *name, const char *ext) {
+    size_t len = strlen(name);
+    char *path = malloc(len + strlen(ext) + 1);
+    FILE *f;
+
+    if (!path)
+        return NULL;
+    memcpy(path, name, len);
+    strcpy(path + len, ext);
+    f = fopen(path, "wb+");
+    free(path);
+    return f;
+}
+
+/**
+ * @brief Rewrites both headers, so that the files describe what they hold so far
+ *
+ * @param t (Trace)
+ */
+static void trace_headers(trace_t *t) {
+    long pos = ftell(t->samples);
+
+    if (fseek(t->samples, 0, SEEK_SET) || fwrite(&t->header, sizeof(trace_header_t), 1, t->samples) != 1 ||
+        fseek(t->samples, pos, SEEK_SET))
+        t->error = 1;
+    pos = ftell(t->events);
+    if (fseek(t->events, 0, SEEK_SET) || fwrite(&t->events_header, sizeof(trace_events_header_t), 1, t->events) != 1 ||
+        fseek(t->events, pos, SEEK_SET))
+        t->error = 1;
+}
+
+/**
+ * @brief Appends the chunk being filled and starts the next one
+ *
+ * @param t (Trace)
+ */
+static void trace_flush(trace_t *t) {
+    trace_chunk_t *c = (trace_chunk_t *)t->chunk;
+
+    c->event_count = t->events_header.events - c->event_first;
+    if (fwrite(t->chunk, t->header.chunk_size, 1, t->samples) != 1)
+        t->error = 1;
+    t->header.ticks = t->sampled;
+    trace_headers(t);
+    memset(t->chunk, 0, t->header.chunk_size);
+}
+
+trace_t *trace_create(const char *name, int robots, uint64_t seed) {
+    trace_t *t = calloc(1, sizeof(trace_t));
+
+    if (!t)
+        return NULL;
+    memcpy(t->header.magic, TRACE_MAGIC, sizeof(t->header.magic));
+    t->header.version = TRACE_VERSION;
+    t->header.robots = robots;
+    t->header.chunk_ticks = TRACE_CHUNK_TICKS;
+    t->header.tick_cycles = KILO_TICK_CYCLES;
+    t->header.chunk_size = trace_column_offset(robots, TRACE_COLUMNS);
+    t->header.seed = seed;
+    memcpy(t->events_header.magic, TRACE_EVENTS_MAGIC, sizeof(t->events_header.magic));
+    t->events_header.version = TRACE_VERSION;
+    t->events_header.robots = robots;
+
+    t->chunk = calloc(1, t->header.chunk_size);
+    t->samples = trace_file(name, ".ktrace");
+    t->events = trace_file(name, ".kevents");
+    if (!t->chunk || !t->samples || !t->events ||
+        fwrite(&t->header, sizeof(trace_header_t), 1, t->samples) != 1 ||
+        fwrite(&t->events_header, sizeof(trace_events_header_t), 1, t->events) != 1) {
+        if (t->samples)
+            fclose(t->samples);
+        if (t->events)
+            fclose(t->events);
+        free(t->chunk);
+        free(t);
+        return NULL;
+    }
+    return t;
+}
+
+uint64_t trace_next(const trace_t *t) {
+    return (uint64_t)t->sampled * t->header.tick_cycles;
+}
+
+int trace_sample(trace_t *t, const bodies_t *b) {
+    trace_chunk_t *c = (trace_chunk_t *)t->chunk;
+    uint32_t n = t->header.robots, row = t->sampled % TRACE_CHUNK_TICKS, i;
+    float *x, *y, *theta;
+    uint8_t *color, *left, *right;
+
+    if (row == 0) {
+        if (t->sampled)
+            trace_flush(t);
+        c->first_tick = t->sampled;
+        c->event_first = t->events_header.events;
+    }
+    x = (float *)(t->chunk + trace_column_offset(n, TRACE_X)) + row * n;
+    y = (float *)(t->chunk + trace_column_offset(n, TRACE_Y)) + row * n;
+    theta = (float *)(t->chunk + trace_column_offset(n, TRACE_THETA)) + row * n;
+    color = t->chunk + trace_column_offset(n, TRACE_COLOR) + row * n;
+    left = t->chunk + trace_column_offset(n, TRACE_MOTOR_LEFT) + row * n;
+    right = t->chunk + trace_column_offset(n, TRACE_MOTOR_RIGHT) + row * n;
+    for (i = 0; i < n; i++) {
+        x[i] = (float)b->x[i];
+        y[i] = (float)b->y[i];
+        theta[i] = (float)b->theta[i];
+        color[i] = b->color[i];
+        left[i] = b->motor_left[i];
+        right[i] = b->motor_right[i];
+    }
+    c->ticks = row + 1;
+    t->sampled++;
+    return t->error ? -1 : 0;
+}
+
+int trace_event(trace_t *t, const trace_event_t *e) {
+    if (fwrite(e, sizeof(trace_event_t), 1, t->events) != 1)
+        t->error = 1;
+    t->events_header.events++;
+    return t->error ? -1 : 0;
+}
+
+/**
+ * @brief Appends the whole of one file to another
+ *
+ * @param from (File to copy, read with pread(): its position stays where it is)
+ * @param to (File to append to)
+ * @return int (0 on success, -1 on a read or write error)
+ */
+static int trace_copy(FILE *from, FILE *to) {
+    char buf[65536];
+    off_t at = 0;
+    ssize_t n;
+
+    if (fflush(from))
+        return -1;
+    while ((n = pread(fileno(from), buf, sizeof(buf), at)) > 0) {
+        if (fwrite(buf, 1, n, to) != (size_t)n)
+            return -1;
+        at += n;
+    }
+    return n < 0 ? -1 : 0;
+}
+
+int trace_branch(trace_t *t, const char *name) {
+    FILE *samples = trace_file(name, ".ktrace");
+    FILE *events = trace_file(name, ".kevents");
+
+    if (!samples || !events || trace_copy(t->samples, samples) || trace_copy(t->events, events)) {
+        if (samples)
+            fclose(samples);
+        if (events)
+            fclose(events);
+        return -1;
+    }
+    fclose(t->samples);
+    fclose(t->events);
+    t->samples = samples;
+    t->events = events;
+    return 0;
+}
+
+int trace_close(trace_t *t) {
+    int error;
+
+    if (t->sampled > t->header.ticks)
+        trace_flush(t);
+    else
+        trace_headers(t);
+    if (fclose(t->samples) | fclose(t->events))
+        t->error = 1;
+    error = t->error;
+    free(t->chunk);
+    free(t);
+    return error ? -1 : 0;
+}
+
+/**
+ * @brief Maps NAME plus an extension
+ *
+ * @param name (Path without the extension)
+ * @param ext (Extension)
+ * @param size (Receives the size of the file)
+ * @return const void* (Start of the file, or NULL on failure)
+ */
+static const void *trace_mmap(const char *name, const char *ext, size_t *size) {
+    size_t len = strlen(name);
+    char *path = malloc(len + strlen(ext) + 1);
+    struct stat st;
+    void *p = MAP_FAILED;
+    int fd;
+
+    if (!path)
+        return NULL;
+    memcpy(path, name, len);
+    strcpy(path + len, ext);
+    fd = open(path, O_RDONLY);
+    free(path);
+    if (fd < 0)
+        return NULL;
+    if (!fstat(fd, &st) && st.st_size > 0) {
+        *size = st.st_size;
+        p = mmap(NULL, *size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    return p == MAP_FAILED ? NULL : p;
+}
+
+int trace_map(trace_view_t *v, const char *name) {
+    memset(v, 0, sizeof(trace_view_t));
+    v->header = trace_mmap(name, ".ktrace", &v->size);
+    v->events_header = trace_mmap(name, ".kevents", &v->events_size);
+    if (!v->header || !v->events_header || v->size < sizeof(trace_header_t) ||
+        v->events_size < sizeof(trace_events_header_t) ||
+        memcmp(v->header->magic, TRACE_MAGIC, sizeof(v->header->magic)) ||
+        memcmp(v->events_header->magic, TRACE_EVENTS_MAGIC, sizeof(v->events_header->magic)) ||
+        v->header->version != TRACE_VERSION || v->header->chunk_ticks != TRACE_CHUNK_TICKS ||
+        v->header->chunk_size != trace_column_offset(v->header->robots, TRACE_COLUMNS)) {
+        trace_unmap(v);
+        return -1;
+    }
+    v->chunks = (v->header->ticks + TRACE_CHUNK_TICKS - 1) / TRACE_CHUNK_TICKS;
+    if (sizeof(trace_header_t) + v->chunks * v->header->chunk_size > v->size) {
+        trace_unmap(v);
+        return -1;
+    }
+    v->events = (const trace_event_t *)(v->events_header + 1);
+    v->events_n = (v->events_size - sizeof(trace_events_header_t)) / sizeof(trace_event_t);
+    if (v->events_n > v->events_header->events)
+        v->events_n = v->events_header->events;
+    return 0;
+}
+
+void trace_unmap(trace_view_t *v) {
+    if (v->header)
+        munmap((void *)v->header, v->size);
+    if (v->events_header)
+        munmap((void *)v->events_header, v->events_size);
+    memset(v, 0, sizeof(trace_view_t));
+}
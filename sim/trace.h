@@ -0,0 +1,247 @@
+/**
+ * @file trace.h
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Binary trace of a simulation run: robot state every kilo tick and message events
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bodies.h"
+
+/**
+ * A trace is two append-only files that readers mmap and use in place.
+ *
+ * NAME.ktrace: a trace_header_t, then chunks of TRACE_CHUNK_TICKS samples of
+ * every robot, one sample per kilo tick (KILO_TICK_CYCLES). All chunks have
+ * the same size, the last one included, so the sample of any tick is found
+ * by arithmetic. A chunk is a trace_chunk_t followed by one column per
+ * field (see trace_column_t), each holding a row of every robot per tick
+ * and starting on a 64-byte boundary.
+ *
+ * NAME.kevents: a trace_events_header_t, then one trace_event_t per frame
+ * that reached a receiver, or failed to, in order of time. Each chunk holds
+ * the index of its first event.
+ */
+
+#define TRACE_MAGIC        "KTRACE1"   // first bytes of NAME.ktrace
+#define TRACE_EVENTS_MAGIC "KEVENTS"   // first bytes of NAME.kevents
+#define TRACE_VERSION      1
+#define TRACE_CHUNK_TICKS  256          // samples per chunk
+#define TRACE_NOBODY       0xFFFF       // receiver of events that concern no receiver in particular
+#define TRACE_NO_DISTANCE  255          // distance of events that were not decoded
+
+/**
+ * @brief Fields sampled every tick, in the order of their columns.
+ */
+typedef enum {
+    TRACE_X,            //  float, mm
+    TRACE_Y,            //  float, mm
+    TRACE_THETA,        //  float, rad
+    TRACE_COLOR,        //  uint8_t, set_color()
+    TRACE_MOTOR_LEFT,   //  uint8_t, set_motors()
+    TRACE_MOTOR_RIGHT,  //  uint8_t, set_motors()
+    TRACE_COLUMNS
+} trace_column_t;
+
+/**
+ * @brief What happened to a frame at one receiver.
+ */
+typedef enum {
+    TRACE_RECEIVED,     //  handed to the receiver's kilo_message_rx
+    TRACE_LOST,         //  corrupted by a collision
+    TRACE_DROPPED,      //  the receiver's queue of frames (KILO_RX_QUEUE) was full
+    TRACE_BAD_CRC,      //  sent with a wrong CRC, decoded by nobody (receiver TRACE_NOBODY)
+} trace_status_t;
+
+/**
+ * @brief Header of NAME.ktrace.
+ */
+typedef struct {
+    char magic[8];          //  TRACE_MAGIC
+    uint32_t version;       //  TRACE_VERSION
+    uint32_t robots;        //  robots in every sample, indexed by kilo_uid
+    uint32_t chunk_ticks;   //  samples per chunk
+    uint32_t ticks;         //  samples written so far
+    uint64_t tick_cycles;   //  time between two samples (cycles)
+    uint64_t chunk_size;    //  size of a chunk (bytes)
+    uint64_t seed;          //  run seed
+    uint8_t pad[16];
+} trace_header_t;
+
+/**
+ * @brief Header of one chunk of NAME.ktrace.
+ */
+typedef struct {
+    uint32_t first_tick;    //  tick of the first sample
+    uint32_t ticks;         //  samples in the chunk, TRACE_CHUNK_TICKS except maybe in the last one
+    uint64_t event_first;   //  first event at or after the first sample
+    uint64_t event_count;   //  events until the first sample of the next chunk
+    uint8_t pad[40];
+} trace_chunk_t;
+
+/**
+ * @brief Header of NAME.kevents.
+ */
+typedef struct {
+    char magic[8];          //  TRACE_EVENTS_MAGIC
+    uint32_t version;       //  TRACE_VERSION
+    uint32_t robots;        //  robots of the run
+    uint64_t events;        //  events written so far
+    uint8_t pad[40];
+} trace_events_header_t;
+
+/**
+ * @brief One frame at one receiver.
+ */
+typedef struct {
+    uint64_t time;          //  when it happened (cycles)
+    uint16_t sender;        //  kilo_uid of the sender
+    uint16_t receiver;      //  kilo_uid of the receiver, TRACE_NOBODY for TRACE_BAD_CRC
+    int16_t high_gain;      //  signal strength the receiver measured
+    int16_t low_gain;
+    uint8_t distance;       //  estimate_distance() on the receiver, TRACE_NO_DISTANCE unless received
+    uint8_t status;         //  trace_status_t
+    uint8_t pad[6];
+} trace_event_t;
+
+/**
+ * @brief Offset of a column within a chunk.
+ *
+ * @param robots (Robots of the trace)
+ * @param column (Column)
+ * @return size_t (Offset from the start of the chunk, bytes)
+ */
+static inline size_t trace_column_offset(uint32_t robots, trace_column_t column) {
+    size_t floats = ((size_t)TRACE_CHUNK_TICKS * robots * sizeof(float) + 63) & ~(size_t)63;
+    size_t bytes = ((size_t)TRACE_CHUNK_TICKS * robots + 63) & ~(size_t)63;
+
+    if (column <= TRACE_THETA)
+        return sizeof(trace_chunk_t) + column * floats;
+    return sizeof(trace_chunk_t) + 3 * floats + (column - TRACE_COLOR) * bytes;
+}
+
+typedef struct trace trace_t;
+
+/**
+ * @brief Create NAME.ktrace and NAME.kevents, replacing any previous trace.
+ *
+ * @param name (Path of the files without their extension)
+ * @param robots (Robots in every sample)
+ * @param seed (Run seed)
+ * @return trace_t* (New trace, or NULL if a file cannot be created)
+ */
+trace_t *trace_create(const char *name, int robots, uint64_t seed);
+
+/**
+ * @brief Time of the next sample.
+ *
+ * @param t (Trace)
+ * @return uint64_t (Cycles)
+ */
+uint64_t trace_next(const trace_t *t);
+
+/**
+ * @brief Record the state of every robot at the time of the next sample.
+ *
+ * @param t (Trace)
+ * @param b (State of the robots)
+ * @return int (0 on success, -1 on a write error)
+ */
+int trace_sample(trace_t *t, const bodies_t *b);
+
+/**
+ * @brief Record a message event, no earlier than the last sample.
+ *
+ * @param t (Trace)
+ * @param e (Event)
+ * @return int (0 on success, -1 on a write error)
+ */
+int trace_event(trace_t *t, const trace_event_t *e);
+
+/**
+ * @brief Move a trace to new files NAME.ktrace and NAME.kevents, holding what it recorded so far.
+ *
+ * Meant for a process forked from the one that created the trace: the old
+ * files are read without moving the position that process shares, and
+ * left to it.
+ *
+ * @param t (Trace)
+ * @param name (Path of the new files without their extension)
+ * @return int (0 on success, -1 if the files cannot be created or copied; the trace keeps its files then)
+ */
+int trace_branch(trace_t *t, const char *name);
+
+/**
+ * @brief Write the last samples, close the files and free the trace.
+ *
+ * @param t (Trace)
+ * @return int (0 on success, -1 if some data could not be written)
+ */
+int trace_close(trace_t *t);
+
+/**
+ * @brief A trace mapped in memory for reading.
+ */
+typedef struct {
+    const trace_header_t *header;           //  start of NAME.ktrace
+    size_t size;                            //  its size
+    const trace_events_header_t *events_header;  //  start of NAME.kevents
+    size_t events_size;                     //  its size
+    const trace_event_t *events;            //  the events
+    uint64_t events_n;                      //  number of events
+    uint32_t chunks;                        //  number of chunks
+} trace_view_t;
+
+/**
+ * @brief Map NAME.ktrace and NAME.kevents.
+ *
+ * @param v (Receives the view)
+ * @param name (Path of the files without their extension)
+ * @return int (0 on success, -1 if a file is missing or not a trace)
+ */
+int trace_map(trace_view_t *v, const char *name);
+
+/**
+ * @brief Unmap a trace.
+ *
+ * @param v (View)
+ */
+void trace_unmap(trace_view_t *v);
+
+/**
+ * @brief Chunk @p k of a mapped trace.
+ *
+ * @param v (View)
+ * @param k (Chunk, below v->chunks)
+ * @return const trace_chunk_t* (Chunk header, followed by its columns)
+ */
+static inline const trace_chunk_t *trace_chunk(const trace_view_t *v, uint32_t k) {
+    return (const trace_chunk_t *)((const uint8_t *)v->header + sizeof(trace_header_t) + k * v->header->chunk_size);
+}
+
+/**
+ * @brief Row of a column at a given tick: the value of every robot.
+ *
+ * @param v (View)
+ * @param tick (Tick, below v->header->ticks)
+ * @param column (Column)
+ * @return const void* (float or uint8_t row, indexed by kilo_uid)
+ */
+static inline const void *trace_row(const trace_view_t *v, uint32_t tick, trace_column_t column) {
+    const uint8_t *chunk = (const uint8_t *)trace_chunk(v, tick / v->header->chunk_ticks);
+    size_t size = column <= TRACE_THETA ? sizeof(float) : sizeof(uint8_t);
+
+    return chunk + trace_column_offset(v->header->robots, column) + (size_t)(tick % v->header->chunk_ticks) * v->header->robots * size;
+}
+
+#endif//__TRACE_H__
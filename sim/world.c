@@ -0,0 +1,1250 @@
+/**
+ * @file world.c
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Simulated arena: robot motion, IR messaging and the kilo_host_*() hooks
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "philox.h"
+#include "world.h"
+#include "../kilolib/message_crc.h"
+
+/** Robot whose program is currently running, NULL while the scheduler runs. */
+static robot_t *current;
+
+/**
+ * @brief splitmix64 generator used for everything random in the world
+ *
+ * @param state (Generator state, updated)
+ * @return uint64_t (64 random bits)
+ */
+static uint64_t splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Uniform random number in [0, 1)
+ *
+ * @param state (Generator state, updated)
+ * @return double (Random number)
+ */
+static double uniform(uint64_t *state) {
+    return (splitmix64(state) >> 11) * (1.0/9007199254740992.0);
+}
+
+world_t *world_create(const world_config_t *config) {
+    world_t *w = calloc(1, sizeof(world_t));
+    uint64_t rng;
+    int i;
+
+    if (!w)
+        return NULL;
+    w->config = *config;
+    w->ir = malloc(IR_PROFILES * sizeof(ir_profile_t));
+    if (!w->ir || grid_init(&w->grid, WORLD_IR_RANGE)) {
+        free(w->ir);
+        free(w);
+        return NULL;
+    }
+    //  receivers differ in sensitivity by up to 10% either way
+    rng = config->seed ^ 0x8CB92BA72F3D8DD7ULL;
+    for (i = 0; i < IR_PROFILES; i++) {
+        double gain_high = 0.9 + 0.2*uniform(&rng);
+        ir_profile_init(&w->ir[i], gain_high, 0.9 + 0.2*uniform(&rng));
+    }
+    sched_init(&w->sched);
+    if (w->config.threads > 1)
+        w->pool = pool_create(w->config.threads);
+    w->scratch = calloc(pool_workers(w->pool), sizeof(world_scratch_t));
+    if (!w->scratch) {
+        world_destroy(w);
+        return NULL;
+    }
+    return w;
+}
+
+/**
+ * @brief Body of a robot's task: power on and run the program's main()
+ *
+ * @param arg (The robot)
+ */
+static void robot_main(void *arg) {
+    robot_t *r = arg;
+    r->program->main();
+    r->halted = 1;
+    task_yield();
+}
+
+/**
+ * @brief Writes the factory calibration of a robot into its EEPROM image
+ *
+ * @param r (Robot to calibrate)
+ * @param rng (Generator state of the world)
+ */
+static void robot_calibrate(robot_t *r, uint64_t *rng) {
+    bodies_t *b = &r->world->bodies;
+    uint8_t *e = r->cpu.eeprom;
+    int i;
+
+    memset(e, 0xFF, EEPROM_SIZE);
+    e[(uintptr_t)EEPROM_OSCCAL] = 0x80;
+    e[(uintptr_t)EEPROM_TXMASK] = TX_MASK_MIN;
+    e[(uintptr_t)EEPROM_UID] = r->id & 0xFF;
+    e[(uintptr_t)EEPROM_UID+1] = r->id >> 8;
+    e[(uintptr_t)EEPROM_LEFT_ROTATE] = 65 + splitmix64(rng) % 11;
+    e[(uintptr_t)EEPROM_RIGHT_ROTATE] = 65 + splitmix64(rng) % 11;
+    e[(uintptr_t)EEPROM_LEFT_STRAIGHT] = 65 + splitmix64(rng) % 11;
+    e[(uintptr_t)EEPROM_RIGHT_STRAIGHT] = 65 + splitmix64(rng) % 11;
+
+    //  the robot reaches its nominal speed at the calibrated duty cycles, give or take a few percent
+    b->gain_left[r->id] = (0.95 + 0.1*uniform(rng)) / e[(uintptr_t)EEPROM_LEFT_STRAIGHT];
+    b->gain_right[r->id] = (0.95 + 0.1*uniform(rng)) / e[(uintptr_t)EEPROM_RIGHT_STRAIGHT];
+
+    //  the stored tables are the receiver's response at the calibration distances
+    r->ir = &r->world->ir[splitmix64(rng) % IR_PROFILES];
+    for (i = 0; i < 14; i++) {
+        e[(uintptr_t)EEPROM_IRHIGH + 2*i] = r->ir->cal_high[i] >> 8;
+        e[(uintptr_t)EEPROM_IRHIGH + 2*i+1] = r->ir->cal_high[i] & 0xFF;
+        e[(uintptr_t)EEPROM_IRLOW + 2*i] = r->ir->cal_low[i] >> 8;
+        e[(uintptr_t)EEPROM_IRLOW + 2*i+1] = r->ir->cal_low[i] & 0xFF;
+    }
+}
+
+/**
+ * @brief Variables of a program, recorded the first time a robot runs it
+ *
+ * @param w (World)
+ * @param program (Program)
+ * @return world_image_t* (Image of the program, NULL on allocation failure)
+ */
+static world_image_t *world_image(world_t *w, const kilobot_program_t *program) {
+    world_image_t *im, **images;
+    int i;
+
+    for (i = 0; i < w->images_n; i++)
+        if (w->images[i]->program == program)
+            return w->images[i];
+    images = realloc(w->images, (w->images_n + 1) * sizeof(world_image_t *));
+    if (!images)
+        return NULL;
+    w->images = images;
+    im = calloc(1, sizeof(world_image_t));
+    if (!im)
+        return NULL;
+    im->program = program;
+    im->data_size = program->data_end - program->data_start;
+    im->bss_size = program->bss_end - program->bss_start;
+    im->pristine = malloc(im->data_size + im->bss_size + 1);
+    if (!im->pristine) {
+        free(im);
+        return NULL;
+    }
+    memcpy(im->pristine, program->data_start, im->data_size);
+    memcpy(im->pristine + im->data_size, program->bss_start, im->bss_size);
+    im->stride = (im->data_size + im->bss_size + 63) & ~(size_t)63;
+    w->images[w->images_n++] = im;
+    return im;
+}
+
+/**
+ * @brief Copy of a program's variables that belongs to one robot
+ *
+ * @param im (Image of the program)
+ * @param slot (Slot of the robot)
+ * @return uint8_t* (The robot's variables)
+ */
+static inline uint8_t *image_slot(const world_image_t *im, int slot) {
+    return im->arena + (size_t)slot * im->stride;
+}
+
+/**
+ * @brief Gives a new robot its own copy of the program's initial variables
+ *
+ * @param im (Image of the program)
+ * @return int (Slot of the copy, -1 on allocation failure)
+ */
+static int image_add(world_image_t *im) {
+    if (im->slots == im->capacity) {
+        int capacity = im->capacity ? 2*im->capacity : 16;
+        uint8_t *arena;
+        //  programs without variables still get distinct, valid slots
+        if (posix_memalign((void **)&arena, 64, capacity * im->stride + 64))
+            return -1;
+        if (im->arena)
+            memcpy(arena, im->arena, im->slots * im->stride);
+        free(im->arena);
+        im->arena = arena;
+        im->capacity = capacity;
+    }
+    memcpy(image_slot(im, im->slots), im->pristine, im->data_size + im->bss_size);
+    return im->slots++;
+}
+
+/**
+ * @brief Copies the program's variables out of their sections
+ *
+ * @param im (Image of the program)
+ * @param state (Receives the variables)
+ */
+static void image_save(const world_image_t *im, uint8_t *state) {
+    memcpy(state, im->program->data_start, im->data_size);
+    memcpy(state + im->data_size, im->program->bss_start, im->bss_size);
+}
+
+/**
+ * @brief Copies a robot's variables into the program's sections
+ *
+ * @param im (Image of the program)
+ * @param state (Variables to load)
+ */
+static void image_load(const world_image_t *im, const uint8_t *state) {
+    memcpy(im->program->data_start, state, im->data_size);
+    memcpy(im->program->bss_start, state + im->data_size, im->bss_size);
+}
+
+robot_t *world_add_robot(world_t *w, const kilobot_program_t *program, double x, double y, double theta) {
+    robot_t *r;
+    uint64_t rng;
+
+    if (w->n == w->capacity) {
+        int capacity = w->capacity ? 2*w->capacity : 16;
+        robot_t **robots = realloc(w->robots, capacity*sizeof(robot_t *));
+        if (!robots)
+            return NULL;
+        w->robots = robots;
+        if (bodies_grow(&w->bodies, w->n, capacity))
+            return NULL;
+        w->capacity = capacity;
+    }
+    r = calloc(1, sizeof(robot_t));
+    if (!r)
+        return NULL;
+    r->id = w->n;
+    r->world = w;
+    r->program = program;
+    r->image = world_image(w, program);
+    r->slot = r->image ? image_add(r->image) : -1;
+    if (r->slot < 0) {
+        free(r);
+        return NULL;
+    }
+    w->bodies.x[r->id] = x;
+    w->bodies.y[r->id] = y;
+    w->bodies.theta[r->id] = theta;
+    w->bodies.motor_left[r->id] = w->bodies.motor_right[r->id] = 0;
+    w->bodies.color[r->id] = 0;
+
+    rng = w->config.seed ^ (0xD1B54A32D192ED03ULL * (uint64_t)(r->id + 1));
+    robot_calibrate(r, &rng);
+
+    kilo_host_power_on(&r->cpu);
+    //  robots are switched on at different times: timer0 matches at an arbitrary phase
+    r->timer_ocr = 0xFF;
+    r->timer_next = w->now + splitmix64(&rng) % KILO_TICK_CYCLES;
+    r->wake_at = w->now;
+
+    r->task = task_create(robot_main, r, WORLD_STACK_SIZE);
+    if (!r->task) {
+        r->image->slots--;
+        free(r);
+        return NULL;
+    }
+    if (grid_insert(&w->grid, x, y) < 0 || sched_add(&w->sched, r->wake_at) < 0) {
+        task_destroy(r->task);
+        r->image->slots--;
+        free(r);
+        return NULL;
+    }
+    w->robots[w->n++] = r;
+    return r;
+}
+
+/**
+ * @brief Runs a robot's program until it blocks again
+ *
+ * @param r (Robot to run)
+ */
+static void robot_run(robot_t *r) {
+    world_image_t *im = r->image;
+
+    //  the sections keep the last robot's variables until another robot of the program runs
+    if (im->resident != r) {
+        if (im->resident)
+            image_save(im, image_slot(im, im->resident->slot));
+        image_load(im, image_slot(im, r->slot));
+        im->resident = r;
+    }
+    current = r;
+    kilo_host_switch_in(&r->cpu);
+    task_resume(r->task);
+    kilo_host_switch_out(&r->cpu);
+    current = NULL;
+}
+
+/**
+ * @brief Checks whether a robot's IR LED was on at some point of an interval
+ *
+ * @param r (Robot)
+ * @param begin (Start of the interval)
+ * @param end (End of the interval, excluded)
+ * @param frame (Non-zero to count the dark gap between the first start bit and the rest of a frame)
+ * @return int (Non-zero if it was)
+ */
+static int robot_emits(const robot_t *r, kilo_cycles_t begin, kilo_cycles_t end, int frame) {
+    int k;
+
+    //  the last emission is the one that ends last
+    if (r->bursts[(r->bursts_next + WORLD_BURSTS - 1) % WORLD_BURSTS].end <= begin)
+        return 0;
+    for (k = 0; k < WORLD_BURSTS; k++) {
+        const world_burst_t *b = &r->bursts[k];
+        if (b->end == b->begin || b->begin >= end || b->end <= begin)
+            continue;
+        if (frame || begin < b->begin + WORLD_BIT_CYCLES || (b->data < b->end && b->data < end))
+            return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Checks whether a robot's receiver picks up another robot's IR LED during an interval
+ *
+ * @param w (World)
+ * @param r (Listening robot)
+ * @param begin (Start of the interval)
+ * @param end (End of the interval, excluded)
+ * @param frame (Non-zero to count the dark gap between the first start bit and the rest of a frame)
+ * @return int (Non-zero if it does)
+ */
+static int channel_busy(const world_t *w, const robot_t *r, kilo_cycles_t begin, kilo_cycles_t end, int frame) {
+    const bodies_t *b = &w->bodies;
+    uint32_t buckets[GRID_NEIGHBORHOOD];
+    int n = grid_neighborhood(&w->grid, b->x[r->id], b->y[r->id], buckets), k, j;
+
+    for (k = 0; k < n; k++) {
+        for (j = w->grid.head[buckets[k]]; j >= 0; j = w->grid.next[j]) {
+            double dx = b->x[j] - b->x[r->id], dy = b->y[j] - b->y[r->id];
+            if (j == r->id || dx*dx + dy*dy > WORLD_IR_RANGE*WORLD_IR_RANGE)
+                continue;
+            if (robot_emits(w->robots[j], begin, end, frame))
+                return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Keeps the current robot inside an interrupt handler until @p until
+ *
+ * Interrupts are off while message_send() runs: nothing else of the robot
+ * runs, and its pending interrupts wait.
+ *
+ * @param r (Current robot)
+ * @param until (End of the stall)
+ */
+static void robot_stall(robot_t *r, kilo_cycles_t until) {
+    kilo_cycles_t wake_at = r->wake_at;
+
+    r->stalled += until - r->world->now;
+    r->wake_at = until;
+    while (r->world->now < until)
+        task_yield();
+    r->wake_at = wake_at;
+}
+
+/**
+ * @brief Time between two timer0 compare matches
+ *
+ * @param from (OCR0A value of the earlier match, which the counter then holds)
+ * @param to (OCR0A value of the later match)
+ * @return kilo_cycles_t (Cycles between the two matches)
+ */
+static inline kilo_cycles_t timer_delta(uint8_t from, uint8_t to) {
+    uint8_t counts = to - from;
+    return (kilo_cycles_t)(counts ? counts : 256) * KILO_TIMER0_PRESCALE;
+}
+
+/**
+ * @brief Time of a robot's timer0 interrupt after @p k interrupts that cannot transmit
+ *
+ * Such interrupts leave OCR0A at 0xFF, so only the first interval can differ
+ * from a full tick.
+ *
+ * @param r (Robot)
+ * @param k (Number of interrupts before it)
+ * @return kilo_cycles_t (Time of the interrupt)
+ */
+static kilo_cycles_t robot_timer_at(const robot_t *r, uint32_t k) {
+    if (k == 0)
+        return r->timer_next;
+    if (k == UINT32_MAX)
+        return WORLD_NEVER;
+    return r->timer_next + timer_delta(r->timer_ocr, 0xFF) + (kilo_cycles_t)(k - 1) * KILO_TICK_CYCLES;
+}
+
+/**
+ * @brief Time at which a robot must next be resumed
+ *
+ * A robot between two loop() calls runs again at its next interrupt. A robot
+ * in delay() only needs to run when the delay ends, a frame arrives or a
+ * timer interrupt may transmit; the interrupts in between are applied in one
+ * go when it resumes.
+ *
+ * @param r (Robot)
+ * @return kilo_cycles_t (Time of its next event, WORLD_NEVER if none)
+ */
+static kilo_cycles_t robot_next_event(const robot_t *r) {
+    kilo_cycles_t t;
+
+    if (r->halted)
+        return WORLD_NEVER;
+    if (r->cpu.in_isr)  // interrupts stay pending until the handler returns
+        return r->wake_at;
+    //  queued frames wait for the receive interrupt, or with KILO_RX_DEFERRED for kilo_start()
+    if (!SPSC_empty(r->cpu.rx_queue) && (KILO_HOST_RX_IN_ISR || !r->waiting))
+        return r->world->now;
+    if (!r->waiting)
+        return r->wake_at < r->timer_next ? r->wake_at : r->timer_next;
+    t = robot_timer_at(r, r->timer_quiet);
+    return r->wake_at < t ? r->wake_at : t;
+}
+
+/**
+ * @brief Records a message event in the trace of the run
+ *
+ * @param w (World, traced)
+ * @param sender (Sending robot)
+ * @param receiver (Receiving robot, TRACE_NOBODY if none)
+ * @param dist (Signal strength the receiver measured, NULL if none)
+ * @param distance (Distance the receiver estimated, TRACE_NO_DISTANCE if none)
+ * @param status (What happened to the frame)
+ */
+static void world_trace(world_t *w, int sender, int receiver, const distance_measurement_t *dist,
+                        uint8_t distance, trace_status_t status) {
+    trace_event_t e;
+
+    memset(&e, 0, sizeof(e));
+    e.time = w->now;
+    e.sender = sender;
+    e.receiver = receiver;
+    if (dist) {
+        e.high_gain = dist->high_gain;
+        e.low_gain = dist->low_gain;
+    }
+    e.distance = distance;
+    e.status = status;
+    trace_event(w->trace, &e);
+}
+
+/**
+ * @brief Services every interrupt of the current robot that is due
+ *
+ * Runs on the robot's task, like the interrupt handlers run on the kilobot's
+ * stack. Nothing is serviced from inside an interrupt handler.
+ *
+ * @param r (Current robot)
+ * @return int (Number of interrupts serviced, a run of interrupts that cannot transmit counting as one)
+ */
+static int robot_service(robot_t *r) {
+    world_t *w = r->world;
+    int serviced = 0;
+
+    if (r->cpu.in_isr)
+        return 0;
+    while (1) {
+        //  a transmission stalls the robot, so time moves on during the loop
+        kilo_cycles_t now = w->now;
+        if (r->timer_next <= now) {
+            uint32_t quiet = kilo_host_timer_quiet();
+            if (quiet) {
+                //  apply all the interrupts that cannot transmit and are due
+                uint32_t due = 1;
+                kilo_cycles_t second = robot_timer_at(r, 1);
+                if (second <= now) {
+                    kilo_cycles_t more = 1 + (now - second) / KILO_TICK_CYCLES;
+                    due = more < quiet - 1 ? 1 + (uint32_t)more : quiet;
+                }
+                kilo_host_timer_skip(due);
+                r->timer_next = robot_timer_at(r, due);
+                r->timer_ocr = 0xFF;
+            } else {
+                uint8_t ocr;
+                //  the receiver is busy from the first start bit it hears to the end of that frame
+                r->cpu.rx_busy = channel_busy(w, r, now, now + 1, 1);
+                kilo_host_timer_isr();
+                //  the counter equals the old OCR0A; it matches again when it reaches the new one
+                ocr = r->cpu.tx_increment;
+                r->timer_next += timer_delta(r->timer_ocr, ocr);
+                r->timer_ocr = ocr;
+            }
+        } else if (KILO_HOST_RX_IN_ISR && !SPSC_empty(r->cpu.rx_queue)) {
+            kilo_host_rx_isr();
+        } else {
+            break;
+        }
+        serviced++;
+    }
+    return serviced;
+}
+
+void kilo_host_wait(kilo_cycles_t cycles) {
+    robot_t *r = current;
+    kilo_cycles_t deadline = r->world->now + cycles, stalled = r->stalled;
+
+    while (1) {
+        robot_service(r);
+        //  delay() counts cycles of the main program: interrupt handlers lengthen it
+        deadline += r->stalled - stalled;
+        stalled = r->stalled;
+        if (r->world->now >= deadline)
+            break;
+        r->wake_at = deadline;
+        r->waiting = 1;
+        r->timer_quiet = kilo_host_timer_quiet();
+        task_yield();
+    }
+    r->wake_at = WORLD_NEVER;
+    r->waiting = 0;
+}
+
+void kilo_host_idle(void) {
+    robot_t *r = current;
+
+    r->wake_at = WORLD_NEVER;
+    r->waiting = 0;
+    while (!robot_service(r) && SPSC_empty(r->cpu.rx_queue))
+        task_yield();
+}
+
+void kilo_host_rx_delivered(int32_t sender, const distance_measurement_t *dist) {
+    robot_t *r = current;
+
+    r->messages_received++;
+    if (r->world->trace)
+        world_trace(r->world, sender, r->id, dist, estimate_distance(dist), TRACE_RECEIVED);
+}
+
+/**
+ * @brief Restarts the world steps if they were stopped
+ *
+ * Steps only run while a robot moves or was just pushed, or a transmission
+ * waits for delivery;
+ * they stay aligned on multiples of WORLD_QUANTUM.
+ *
+ * @param w (World)
+ */
+static void world_wake_steps(world_t *w) {
+    if (!w->moving && !w->pushed_n && !w->tx_n)
+        w->stepped_at = w->now - w->now % WORLD_QUANTUM;
+}
+
+void kilo_host_set_motors(uint8_t left, uint8_t right) {
+    robot_t *r = current;
+    world_t *w = r->world;
+    int was_moving = w->bodies.motor_left[r->id] || w->bodies.motor_right[r->id];
+    int is_moving = left || right;
+
+    if (is_moving && !was_moving) {
+        world_wake_steps(w);
+        w->moving++;
+    } else if (was_moving && !is_moving) {
+        w->moving--;
+    }
+    w->bodies.motor_left[r->id] = left;
+    w->bodies.motor_right[r->id] = right;
+    bodies_update_awake(&w->bodies, r->id);
+}
+
+void kilo_host_set_color(uint8_t color) {
+    current->world->bodies.color[current->id] = color;
+}
+
+/**
+ * @brief Adds measurement noise to an ADC reading
+ *
+ * @param v (Exact reading)
+ * @param sigma (Standard deviation, ADC counts)
+ * @param bits (64 random bits)
+ * @return int16_t (Noisy reading, within the range of the ADC)
+ */
+static int16_t ir_noisy(int16_t v, double sigma, uint64_t bits) {
+    //  the sum of four uniform numbers is close enough to a normal distribution
+    double u = (double)(bits & 0xFFFF) + (double)(bits >> 16 & 0xFFFF) +
+               (double)(bits >> 32 & 0xFFFF) + (double)(bits >> 48);
+    double n = (u / 65536.0 - 2.0) * sqrt(3.0);
+    long r = lround(v + sigma * n);
+
+    return r < 0 ? 0 : r > 1023 ? 1023 : (int16_t)r;
+}
+
+/**
+ * @brief Adds the noise of one delivery to the signal a receiver measures from a sender
+ *
+ * The noise only depends on the run seed, the time and the two robots, so
+ * that any worker of the delivery pass draws the same.
+ *
+ * @param w (World)
+ * @param sender (Transmitting robot)
+ * @param r (Receiving robot)
+ * @param dist (Exact readings, updated)
+ */
+static void ir_measure(const world_t *w, int sender, const robot_t *r, distance_measurement_t *dist) {
+    uint64_t key;
+
+    if (w->config.ir_noise <= 0)
+        return;
+    key = w->config.seed ^ w->now * 0x9FB21C651E98DF25ULL ^ ((uint64_t)sender << 32 | (uint32_t)r->id) * 0xD6E8FEB86659FD93ULL ^
+          w->branch * 0xA0761D6478BD642FULL;
+    dist->high_gain = ir_noisy(dist->high_gain, w->config.ir_noise, splitmix64(&key));
+    dist->low_gain = ir_noisy(dist->low_gain, w->config.ir_noise, splitmix64(&key));
+}
+
+uint8_t kilo_host_message_send(const message_t *msg) {
+    robot_t *s = current;
+    world_t *w = s->world;
+    world_burst_t *b = &s->bursts[s->bursts_next];
+    kilo_cycles_t sense = w->now + 2*WORLD_BIT_CYCLES, data = sense + WORLD_SENSE_CYCLES;
+    message_t m = *msg;  // other robots of the program overwrite it while this one is stalled
+    world_tx_t *tx;
+    int busy;
+
+    //  message_send(): first start bit, then listen and give up on any carrier
+    s->bursts_next = (s->bursts_next + 1) % WORLD_BURSTS;
+    b->begin = w->now;
+    b->data = b->end = w->now + WORLD_BIT_CYCLES;
+    robot_stall(s, sense);
+    busy = channel_busy(w, s, sense, sense + 1, 0);
+    if (!busy) {
+        robot_stall(s, data);
+        //  a robot that started during the poll is only noticed at its end
+        busy = channel_busy(w, s, sense, data, 0);
+    }
+    if (busy) {
+        s->messages_aborted++;
+        return 0;
+    }
+    b->data = data;
+    b->end = data + WORLD_FRAME_BITS * WORLD_BIT_CYCLES;
+    robot_stall(s, b->end);
+
+    s->messages_sent++;
+    if (message_crc(&m) != m.crc) {
+        //  transmitted, but nobody can decode it
+        if (w->trace)
+            world_trace(w, s->id, TRACE_NOBODY, NULL, TRACE_NO_DISTANCE, TRACE_BAD_CRC);
+        return 1;
+    }
+    if (w->tx_n == w->tx_cap) {
+        int cap = w->tx_cap ? 2*w->tx_cap : 64;
+        world_tx_t *p = realloc(w->tx, cap * sizeof(world_tx_t));
+        if (!p)
+            return 1;  // lost
+        w->tx = p;
+        w->tx_cap = cap;
+    }
+    //  the receivers get the frame at the end of the current world step
+    world_wake_steps(w);
+    tx = &w->tx[w->tx_n++];
+    tx->sender = s->id;
+    tx->msg = m;
+    tx->begin = b->begin;
+    tx->end = b->end;
+    return 1;
+}
+
+int16_t kilo_host_adc_read(uint8_t channel) {
+    robot_t *r = current;
+    const bodies_t *b = &r->world->bodies;
+
+    switch (channel) {
+    case 6:     //  battery, about 4 V
+        return 700;
+    case 7: {   //  ambient light from a lamp at the origin
+        double d = sqrt(b->x[r->id]*b->x[r->id] + b->y[r->id]*b->y[r->id]);
+        return (int16_t)(1000.0 / (1.0 + d/250.0)) + (kilo_host_random(KILO_RNG_SENSOR) % 9) - 4;
+    }
+    case 8:     //  temperature
+        return 300;
+    }
+    return 0;
+}
+
+uint32_t kilo_host_random(uint8_t stream) {
+    robot_t *r = current;
+    uint64_t seed = r->world->config.seed;
+    uint32_t key[2] = {(uint32_t)seed, (uint32_t)(seed >> 32)};
+    uint32_t ctr[4] = {r->rng_draws[stream]++, r->rng_seeds[stream], (uint32_t)r->id, stream | r->world->branch << 8};
+
+    philox4x32(ctr, key);
+    return ctr[0];
+}
+
+void kilo_host_random_seed(uint8_t stream, uint32_t seed) {
+    current->rng_seeds[stream] = seed;
+    current->rng_draws[stream] = 0;
+}
+
+int kilo_host_printf(const char *fmt, ...) {
+    va_list ap;
+    int n;
+
+    if (!current || !current->world->config.verbose)
+        return 0;
+    printf("[%10.3f s] #%d: ", current->world->now / (double)KILO_F_CPU, current->id);
+    va_start(ap, fmt);
+    n = vprintf(fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+/**
+ * @brief Appends to an array of a worker's scratch, growing it as needed
+ *
+ * @param a (Array, updated)
+ * @param n (Number of elements, updated)
+ * @param cap (Allocated elements, updated)
+ * @param size (Size of an element)
+ * @return void* (New element)
+ */
+static void *scratch_push(void *a, uint32_t *n, uint32_t *cap, size_t size) {
+    void **array = a;
+    if (*n == *cap) {
+        uint32_t c = *cap ? 2 * *cap : 256;
+        void *p = realloc(*array, c * size);
+        if (!p) {
+            fprintf(stderr, "simulator: out of memory\n");
+            exit(1);
+        }
+        *array = p;
+        *cap = c;
+    }
+    return (char *)*array + (*n)++ * size;
+}
+
+/**
+ * @brief Motion pass task: moves the robots with a motor on in a block of ids
+ *
+ * Robots only write their own pose and stamp their grid bucket; those that
+ * leave their cell are noted and moved in the grid afterwards. Unlike the
+ * collision pass this one is split by ids rather than by grid region: it
+ * makes no neighbour queries, so regions would bring no locality, and
+ * bodies_move() integrates contiguous runs of the pose columns four robots
+ * at a time.
+ *
+ * @param arg (World)
+ * @param task (Block of robots)
+ * @param worker (Worker running the task)
+ */
+static void world_move_task(void *arg, int task, int worker) {
+    world_t *w = arg;
+    bodies_t *b = &w->bodies;
+    world_scratch_t *out = &w->scratch[worker];
+    const double dt = (double)WORLD_QUANTUM / KILO_F_CPU;
+    int i = task * WORLD_ROBOTS_PER_TASK;
+    int end = i + WORLD_ROBOTS_PER_TASK < w->n ? i + WORLD_ROBOTS_PER_TASK : w->n;
+
+    bodies_move(b, i, end, dt);
+    for (; i < end; i += BODIES_WORD) {
+        uint64_t bits = b->awake[i / BODIES_WORD];
+        while (bits) {
+            int j = i + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (!b->motor_left[j] && !b->motor_right[j])
+                continue;
+            grid_touch(&w->grid, j);
+            if (grid_changed(&w->grid, j, b->x[j], b->y[j]))
+                *(int32_t *)scratch_push(&out->moved, &out->moved_n, &out->moved_cap, sizeof(int32_t)) = j;
+        }
+    }
+}
+
+/**
+ * @brief Orders robot ids
+ *
+ * @param a (Robot id)
+ * @param b (Robot id)
+ * @return int (qsort() comparison)
+ */
+static int compare_ids(const void *a, const void *b) {
+    return *(const int32_t *)a - *(const int32_t *)b;
+}
+
+/**
+ * @brief Moves every robot with a motor on by one step, then updates the grid in uid order
+ *
+ * @param w (World)
+ */
+static void world_move(world_t *w) {
+    pool_t *pool = w->moving >= WORLD_PARALLEL_MIN ? w->pool : NULL;
+    int workers = pool_workers(pool), k;
+    uint32_t i;
+    int tasks = (w->n + WORLD_ROBOTS_PER_TASK - 1) / WORLD_ROBOTS_PER_TASK;
+    world_scratch_t *all = &w->scratch[0];
+
+    pool_run(pool, tasks, world_move_task, w);
+    //  gather every worker's list into the first one; the order of the grid's
+    //  bucket lists must not depend on which worker moved a robot
+    for (k = 1; k < workers; k++) {
+        for (i = 0; i < w->scratch[k].moved_n; i++)
+            *(int32_t *)scratch_push(&all->moved, &all->moved_n, &all->moved_cap, sizeof(int32_t)) = w->scratch[k].moved[i];
+        w->scratch[k].moved_n = 0;
+    }
+    qsort(all->moved, all->moved_n, sizeof(int32_t), compare_ids);
+    for (i = 0; i < all->moved_n; i++) {
+        int32_t id = all->moved[i];
+        grid_update(&w->grid, id, w->bodies.x[id], w->bodies.y[id]);
+    }
+    all->moved_n = 0;
+}
+
+/**
+ * @brief Collision pass task: finds the bodies that a run of the checked robots overlap
+ *
+ * Each pair is found once, by the robot that is checked, or by the lower id
+ * when both are. Only reads the world.
+ *
+ * @param arg (World)
+ * @param task (Run of w->checks)
+ * @param worker (Worker running the task)
+ */
+static void world_collide_task(void *arg, int task, int worker) {
+    world_t *w = arg;
+    const bodies_t *b = &w->bodies;
+    world_scratch_t *out = &w->scratch[worker];
+    uint32_t first = (uint32_t)task * WORLD_CHECKS_PER_TASK, m;
+    uint32_t end = first + WORLD_CHECKS_PER_TASK < w->checks_n ? first + WORLD_CHECKS_PER_TASK : w->checks_n;
+
+    for (m = first; m < end; m++) {
+        uint32_t buckets[GRID_NEIGHBORHOOD];
+        int i = w->checks[m].robot, n, k, j;
+
+        n = grid_nearby(&w->grid, b->x[i], b->y[i], WORLD_BODY_DIAMETER, buckets);
+        for (k = 0; k < n; k++) {
+            for (j = w->grid.head[buckets[k]]; j >= 0; j = w->grid.next[j]) {
+                double dx, dy, d2, d, push;
+                world_contact_t *c;
+
+                if (j == i || (j < i && b->awake[j / BODIES_WORD] >> (j % BODIES_WORD) & 1))
+                    continue;
+                dx = b->x[i] - b->x[j];
+                dy = b->y[i] - b->y[j];
+                d2 = dx*dx + dy*dy;
+                if (d2 >= WORLD_BODY_DIAMETER*WORLD_BODY_DIAMETER)
+                    continue;
+                c = scratch_push(&out->contacts, &out->contacts_n, &out->contacts_cap, sizeof(world_contact_t));
+                c->a = i;
+                c->b = j;
+                d = sqrt(d2);
+                if (d == 0) {
+                    //  same centre: part them along x, the lower id to the left
+                    c->dx = (i < j ? -0.5 : 0.5) * WORLD_BODY_DIAMETER;
+                    c->dy = 0;
+                    continue;
+                }
+                //  each body moves half the overlap, along the line of centres
+                push = 0.5 * (WORLD_BODY_DIAMETER - d) / d;
+                c->dx = push * dx;
+                c->dy = push * dy;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Orders checked robots by grid cell, row by row
+ *
+ * @param a (Checked robot)
+ * @param b (Checked robot)
+ * @return int (qsort() comparison)
+ */
+static int compare_checks(const void *a, const void *b) {
+    const world_check_t *p = a, *q = b;
+    if (p->cell != q->cell)
+        return p->cell < q->cell ? -1 : 1;
+    return p->robot - q->robot;
+}
+
+/**
+ * @brief Lists the robots the collision pass checks, split into tasks by grid region
+ *
+ * Those are the robots moving or pushed in the last step (the awake ones):
+ * pushed robots are checked too, so that a clump keeps separating after its
+ * robots stopped. In parallel they are ordered by grid cell, so that each
+ * task covers a strip of neighbouring cells and its grid queries visit the
+ * same few buckets.
+ *
+ * @param w (World)
+ * @param parallel (Whether the pass runs on the pool)
+ * @return int (Number of tasks)
+ */
+static int world_collide_regions(world_t *w, int parallel) {
+    const bodies_t *b = &w->bodies;
+    int i;
+
+    w->checks_n = 0;
+    for (i = 0; i < w->n; i += BODIES_WORD) {
+        uint64_t bits = b->awake[i / BODIES_WORD];
+        while (bits) {
+            int j = i + __builtin_ctzll(bits);
+            world_check_t *c = scratch_push(&w->checks, &w->checks_n, &w->checks_cap, sizeof(world_check_t));
+            bits &= bits - 1;
+            c->cell = (uint64_t)((uint32_t)w->grid.cy[j] ^ 0x80000000u) << 32 | ((uint32_t)w->grid.cx[j] ^ 0x80000000u);
+            c->robot = j;
+        }
+    }
+    if (parallel)
+        qsort(w->checks, w->checks_n, sizeof(world_check_t), compare_checks);
+    return (w->checks_n + WORLD_CHECKS_PER_TASK - 1) / WORLD_CHECKS_PER_TASK;
+}
+
+/**
+ * @brief Orders contacts by their robots
+ *
+ * @param a (Contact)
+ * @param b (Contact)
+ * @return int (qsort() comparison)
+ */
+static int compare_contacts(const void *a, const void *b) {
+    const world_contact_t *p = a, *q = b;
+    return p->a != q->a ? p->a - q->a : p->b - q->b;
+}
+
+/**
+ * @brief Pushes apart the bodies that overlap after the motion pass
+ *
+ * Every contact is resolved from the positions before any of them, so the
+ * result does not depend on their order (a Jacobi step); the pushes are
+ * still added in a fixed order so that the sums are reproducible. Bodies
+ * still overlapping in a dense clump keep separating over the next steps.
+ *
+ * @param w (World)
+ */
+static void world_collide(world_t *w) {
+    pool_t *pool = w->moving + (int)w->pushed_n >= WORLD_PARALLEL_MIN ? w->pool : NULL;
+    int workers = pool_workers(pool), k;
+    uint32_t i;
+    int tasks = world_collide_regions(w, pool != NULL);
+    world_scratch_t *all = &w->scratch[0];
+    bodies_t *b = &w->bodies;
+
+    pool_run(pool, tasks, world_collide_task, w);
+    for (k = 1; k < workers; k++) {
+        for (i = 0; i < w->scratch[k].contacts_n; i++)
+            *(world_contact_t *)scratch_push(&all->contacts, &all->contacts_n, &all->contacts_cap,
+                                             sizeof(world_contact_t)) = w->scratch[k].contacts[i];
+        w->scratch[k].contacts_n = 0;
+    }
+    for (i = 0; i < w->pushed_n; i++) {
+        b->pushed[w->pushed[i]] = 0;
+        bodies_update_awake(b, w->pushed[i]);
+    }
+    w->pushed_n = 0;
+    qsort(all->contacts, all->contacts_n, sizeof(world_contact_t), compare_contacts);
+    for (i = 0; i < all->contacts_n; i++) {
+        world_contact_t *c = &all->contacts[i];
+        b->x[c->a] += c->dx;
+        b->y[c->a] += c->dy;
+        b->x[c->b] -= c->dx;
+        b->y[c->b] -= c->dy;
+    }
+    for (i = 0; i < all->contacts_n; i++) {
+        int32_t ends[2] = {all->contacts[i].a, all->contacts[i].b};
+        for (k = 0; k < 2; k++) {
+            if (b->pushed[ends[k]])
+                continue;
+            grid_update(&w->grid, ends[k], b->x[ends[k]], b->y[ends[k]]);
+            b->pushed[ends[k]] = 1;
+            bodies_update_awake(b, ends[k]);
+            *(int32_t *)scratch_push(&w->pushed, &w->pushed_n, &w->pushed_cap, sizeof(int32_t)) = ends[k];
+        }
+    }
+    all->contacts_n = 0;
+}
+
+/**
+ * @brief Finds the robots other than the sender that emitted while a transmission was on the air
+ *
+ * Any of them within range of a receiver corrupts the frame there; a
+ * receiver that emitted itself cannot hear it either.
+ *
+ * @param w (World)
+ * @param tx (Transmission)
+ * @param out (Scratch of the worker, receives the robots in jammers)
+ */
+static void world_jammers(const world_t *w, const world_tx_t *tx, world_scratch_t *out) {
+    const bodies_t *b = &w->bodies;
+    uint32_t buckets[GRID_NEARBY_MAX];
+    int n = grid_nearby(&w->grid, b->x[tx->sender], b->y[tx->sender], 2*WORLD_IR_RANGE, buckets), k, j;
+
+    out->jammers_n = 0;
+    for (k = 0; k < n; k++) {
+        for (j = w->grid.head[buckets[k]]; j >= 0; j = w->grid.next[j]) {
+            double dx = b->x[j] - b->x[tx->sender], dy = b->y[j] - b->y[tx->sender];
+            if (j == tx->sender || dx*dx + dy*dy > 4*WORLD_IR_RANGE*WORLD_IR_RANGE)
+                continue;
+            if (robot_emits(w->robots[j], tx->begin, tx->end, 0))
+                *(int32_t *)scratch_push(&out->jammers, &out->jammers_n, &out->jammers_cap, sizeof(int32_t)) = j;
+        }
+    }
+}
+
+/**
+ * @brief Finds the robots in IR range of a sender and their exact readings, unless still cached
+ *
+ * The list can only change when a robot moves, comes or leaves in the cells
+ * around the sender, its own moves included; between stationary robots it
+ * is built once and reused for every frame.
+ *
+ * @param w (World)
+ * @param sender (Transmitting robot, whose cache only the worker resolving its transmission touches)
+ */
+static void world_near(const world_t *w, robot_t *sender) {
+    const bodies_t *b = &w->bodies;
+    int s = sender->id;
+    uint32_t buckets[GRID_NEIGHBORHOOD];
+    int n = grid_neighborhood(&w->grid, b->x[s], b->y[s], buckets), k, i;
+
+    if (sender->near_at && grid_unchanged(&w->grid, buckets, n, sender->near_at))
+        return;
+    sender->near_n = 0;
+    sender->near_at = w->grid.clock;
+    for (k = 0; k < n; k++) {
+        for (i = w->grid.head[buckets[k]]; i >= 0; i = w->grid.next[i]) {
+            double dx = b->x[i] - b->x[s], dy = b->y[i] - b->y[s], d2 = dx*dx + dy*dy, d;
+            world_near_t *e;
+
+            if (i == s || d2 > WORLD_IR_RANGE*WORLD_IR_RANGE)
+                continue;
+            d = sqrt(d2);
+            e = scratch_push(&sender->near, &sender->near_n, &sender->near_cap, sizeof(world_near_t));
+            e->robot = i;
+            e->dist.high_gain = ir_lookup(w->robots[i]->ir->high, d);
+            e->dist.low_gain = ir_lookup(w->robots[i]->ir->low, d);
+        }
+    }
+}
+
+/**
+ * @brief Delivery pass task: finds the receivers of a block of transmissions
+ *
+ * Only reads the world, apart from the senders' caches of robots in range;
+ * the receivers are queued afterwards, in the order the transmissions were
+ * made.
+ *
+ * @param arg (World)
+ * @param task (Block of transmissions)
+ * @param worker (Worker running the task)
+ */
+static void world_deliver_task(void *arg, int task, int worker) {
+    world_t *w = arg;
+    const bodies_t *b = &w->bodies;
+    world_scratch_t *out = &w->scratch[worker];
+    int t = task * WORLD_TX_PER_TASK;
+    int end = t + WORLD_TX_PER_TASK < w->tx_n ? t + WORLD_TX_PER_TASK : w->tx_n;
+
+    for (; t < end; t++) {
+        world_tx_t *tx = &w->tx[t];
+        robot_t *sender = w->robots[tx->sender];
+        uint32_t k, m;
+
+        world_near(w, sender);
+        world_jammers(w, tx, out);
+        tx->worker = worker;
+        tx->first = out->hits_n;
+        for (k = 0; k < sender->near_n; k++) {
+            const world_near_t *e = &sender->near[k];
+            robot_t *r = w->robots[e->robot];
+            world_hit_t *hit;
+
+            if (r->halted)
+                continue;
+            hit = scratch_push(&out->hits, &out->hits_n, &out->hits_cap, sizeof(world_hit_t));
+            hit->robot = e->robot;
+            hit->dist = e->dist;
+            ir_measure(w, tx->sender, r, &hit->dist);
+            hit->lost = 0;
+            for (m = 0; m < out->jammers_n && !hit->lost; m++) {
+                double dx = b->x[out->jammers[m]] - b->x[e->robot], dy = b->y[out->jammers[m]] - b->y[e->robot];
+                hit->lost = dx*dx + dy*dy <= WORLD_IR_RANGE*WORLD_IR_RANGE;
+            }
+        }
+        tx->count = out->hits_n - tx->first;
+    }
+}
+
+/**
+ * @brief Delivers the transmissions of the last step to the robots in range
+ *
+ * @param w (World)
+ */
+static void world_deliver(world_t *w) {
+    pool_t *pool = w->tx_n * 64 >= WORLD_PARALLEL_MIN ? w->pool : NULL;
+    int tasks = (w->tx_n + WORLD_TX_PER_TASK - 1) / WORLD_TX_PER_TASK;
+    int t, k;
+    uint32_t i;
+
+    pool_run(pool, tasks, world_deliver_task, w);
+    for (t = 0; t < w->tx_n; t++) {
+        world_tx_t *tx = &w->tx[t];
+        world_hit_t *hits = w->scratch[tx->worker].hits + tx->first;
+        for (i = 0; i < tx->count; i++) {
+            robot_t *r = w->robots[hits[i].robot];
+            if (hits[i].lost) {
+                r->messages_lost++;
+                if (w->trace)
+                    world_trace(w, tx->sender, r->id, &hits[i].dist, TRACE_NO_DISTANCE, TRACE_LOST);
+                continue;
+            }
+            if (!kilo_host_rx_push(&r->cpu, &tx->msg, &hits[i].dist, tx->sender)) {
+                r->messages_dropped++;
+                if (w->trace)
+                    world_trace(w, tx->sender, r->id, &hits[i].dist, TRACE_NO_DISTANCE, TRACE_DROPPED);
+                continue;
+            }
+            sched_update(&w->sched, r->id, robot_next_event(r));
+        }
+    }
+    for (k = 0; k < pool_workers(pool); k++)
+        w->scratch[k].hits_n = 0;
+    w->tx_n = 0;
+}
+
+/**
+ * @brief One world step: motion and collisions, then delivery of the frames sent during the step
+ *
+ * @param w (World)
+ */
+static void world_step(world_t *w) {
+    grid_tick(&w->grid);
+    if (w->moving)
+        world_move(w);
+    if (w->moving || w->pushed_n)
+        world_collide(w);
+    if (w->tx_n)
+        world_deliver(w);
+    w->stepped_at += WORLD_QUANTUM;
+}
+
+void world_run(world_t *w, kilo_cycles_t until) {
+    while (1) {
+        kilo_cycles_t step = w->moving || w->pushed_n || w->tx_n ? w->stepped_at + WORLD_QUANTUM : WORLD_NEVER;
+        kilo_cycles_t sample = w->trace ? trace_next(w->trace) : WORLD_NEVER;
+        kilo_cycles_t limit = step < until ? step : until;
+        kilo_cycles_t event = sched_advance(&w->sched, sample < limit ? sample : limit);
+        robot_t *r;
+
+        //  record the state at each tick before anything that happens at that time
+        if (sample <= step && sample <= event) {
+            if (sample > until)
+                break;
+            w->now = sample;
+            trace_sample(w->trace, &w->bodies);
+            continue;
+        }
+        //  jump to whichever comes first: a world step or a robot's event
+        if (step <= event) {
+            if (step > until)
+                break;
+            w->now = step;
+            world_step(w);
+            continue;
+        }
+        if (event > until)
+            break;
+        w->now = event;
+        r = w->robots[sched_first(&w->sched)];
+        robot_run(r);
+        sched_update(&w->sched, r->id, robot_next_event(r));
+    }
+    if (w->now < until)
+        w->now = until;
+}
+
+int world_fork(world_t *w, int branches, int jobs) {
+    int started = 0, running = 0, failed = 0, status;
+    pid_t pid;
+
+    //  nothing buffered may be written twice, by the parent and by a child
+    fflush(NULL);
+    while (started < branches || running) {
+        if (started < branches && running < (jobs > 0 ? jobs : 1)) {
+            pid = fork();
+            if (pid == 0) {
+                //  only the forking thread lives on in the child: the pool's workers need starting again
+                //  (the old pool's memory is abandoned, its threads cannot be joined). Without them,
+                //  the passes run on this thread, which the scratch of worker 0 is enough for.
+                if (w->pool)
+                    w->pool = pool_create(pool_workers(w->pool));
+                w->branch = started + 1;
+                return w->branch;
+            }
+            if (pid < 0) {
+                failed = 1;
+                branches = started;
+                continue;
+            }
+            started++;
+            running++;
+            continue;
+        }
+        if (wait(&status) < 0)
+            break;
+        running--;
+        failed |= !WIFEXITED(status) || WEXITSTATUS(status);
+    }
+    return failed ? -1 : 0;
+}
+
+void world_destroy(world_t *w) {
+    int i;
+
+    for (i = 0; i < w->n; i++) {
+        task_destroy(w->robots[i]->task);
+        free(w->robots[i]->near);
+        free(w->robots[i]);
+    }
+    for (i = 0; i < w->images_n; i++) {
+        //  leave the sections as the program's startup code left them
+        image_load(w->images[i], w->images[i]->pristine);
+        free(w->images[i]->pristine);
+        free(w->images[i]->arena);
+        free(w->images[i]);
+    }
+    free(w->images);
+    free(w->robots);
+    bodies_free(&w->bodies);
+    grid_free(&w->grid);
+    sched_free(&w->sched);
+    if (w->scratch) {
+        for (i = 0; i < pool_workers(w->pool); i++) {
+            free(w->scratch[i].moved);
+            free(w->scratch[i].contacts);
+            free(w->scratch[i].jammers);
+            free(w->scratch[i].hits);
+        }
+    }
+    free(w->scratch);
+    if (w->pool)
+        pool_destroy(w->pool);
+    free(w->tx);
+    free(w->pushed);
+    free(w->checks);
+    free(w->ir);
+    free(w);
+}
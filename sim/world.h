@@ -0,0 +1,260 @@
+/**
+ * @file world.h
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Simulated arena in which a swarm of host-compiled kilobot programs runs
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef __WORLD_H__
+#define __WORLD_H__
+
+#include <stdint.h>
+
+#include "../kilolib/kilolib_host.h"
+#include "bodies.h"
+#include "grid.h"
+#include "ir.h"
+#include "sched.h"
+#include "pool.h"
+#include "program.h"
+#include "task.h"
+#include "trace.h"
+
+#define WORLD_BODY_DIAMETER  33.0   // diameter of a kilobot (mm)
+#define WORLD_IR_RANGE       100.0  // maximum centre-to-centre distance of IR reception (mm), also the grid cell size
+#define WORLD_SPEED          10.0   // forward speed at the calibrated straight duty cycles (mm/s)
+#define WORLD_TURN_RATE      0.8    // turn rate with one motor at its calibrated duty cycle (rad/s)
+#define WORLD_BIT_CYCLES     269    // IR bit period (rx_bitcycles in message_send.S)
+#define WORLD_SENSE_CYCLES   (WORLD_BIT_CYCLES*7/8*8)  // carrier sense of message_send.S: 235 polls of 8 cycles
+#define WORLD_FRAME_BITS     (1 + 12*10)  // second start bit, then 12 bytes with a start and a stop bit each
+#define WORLD_BURSTS         8      // transmissions of each robot remembered for carrier sense and collisions
+#define WORLD_QUANTUM        KILO_CYCLES_PER_MS  // length of one world step: motion and message delivery (cycles)
+#define WORLD_ROBOTS_PER_TASK 1024               // robots moved by one task of the motion pass, a multiple of BODIES_WORD
+#define WORLD_CHECKS_PER_TASK 128                // robots checked by one task of the collision pass
+#define WORLD_TX_PER_TASK    8                   // transmissions resolved by one task of the delivery pass
+#define WORLD_PARALLEL_MIN   1024                // smallest pass (moving robots, or transmissions x 64) worth running in parallel
+#define WORLD_STACK_SIZE     (64*1024)           // stack of each robot's task (bytes)
+#define WORLD_NEVER          UINT64_MAX
+
+/**
+ * @brief Settings of a simulation run.
+ */
+typedef struct {
+    uint64_t seed;      //  run seed: placement, calibration and entropy derive from it
+    int verbose;        //  forward the robots' printf() output to stdout
+    int threads;        //  threads of the world passes; results do not depend on it
+    double ir_noise;    //  standard deviation of the IR readings (ADC counts), 0 for exact readings
+} world_config_t;
+
+/**
+ * @brief A receiver found for a transmission by the delivery pass.
+ */
+typedef struct {
+    int32_t robot;                //  receiving robot
+    distance_measurement_t dist;  //  signal strength it measures
+    uint8_t lost;                 //  another transmission reached it meanwhile and corrupted the frame
+} world_hit_t;
+
+/**
+ * @brief A robot in IR range of a sender, as cached by the delivery pass.
+ */
+typedef struct {
+    int32_t robot;                //  receiving robot
+    distance_measurement_t dist;  //  signal strength it measures, without noise
+} world_near_t;
+
+/**
+ * @brief What a robot's IR LED emitted for one call of message_send().
+ *
+ * The first start bit, then, unless carrier sense aborted the call, the
+ * rest of the frame. The LED is dark in between, while the robot listens.
+ */
+typedef struct {
+    kilo_cycles_t begin;          //  first start bit
+    kilo_cycles_t data;           //  rest of the frame, until end; equal to end if aborted
+    kilo_cycles_t end;            //  end of the emission
+} world_burst_t;
+
+/**
+ * @brief A transmission waiting for the next world step to reach its receivers.
+ */
+typedef struct {
+    int32_t sender;               //  transmitting robot
+    message_t msg;                //  transmitted message
+    kilo_cycles_t begin, end;     //  on the air from the first start bit to the last stop bit
+    int32_t worker;               //  worker whose hits hold the receivers
+    uint32_t first, count;        //  receivers, as a range of that worker's hits
+} world_tx_t;
+
+/**
+ * @brief Two overlapping bodies found by the collision pass.
+ */
+typedef struct {
+    int32_t a, b;                 //  the robots, a moving or pushed
+    double dx, dy;                //  displacement of a that separates them; b moves the other way
+} world_contact_t;
+
+/**
+ * @brief A robot checked by the collision pass, with its grid cell.
+ */
+typedef struct {
+    uint64_t cell;                //  row, then column of its cell, ordered as unsigned numbers
+    int32_t robot;
+} world_check_t;
+
+/**
+ * @brief Output of one worker of the parallel passes, merged serially afterwards.
+ */
+typedef struct {
+    int32_t *moved;               //  robots whose grid cell changed
+    uint32_t moved_n, moved_cap;
+    world_contact_t *contacts;    //  overlapping bodies
+    uint32_t contacts_n, contacts_cap;
+    world_hit_t *hits;            //  receivers of the transmissions resolved by this worker
+    uint32_t hits_n, hits_cap;
+    int32_t *jammers;             //  robots that emitted during the transmission being resolved
+    uint32_t jammers_n, jammers_cap;
+} __attribute__((aligned(64))) world_scratch_t;
+
+/**
+ * @brief Variables of one program, shared by all the robots that run it.
+ *
+ * Each robot that runs the program owns a slot of the arena, which holds its
+ * copy of the variables while another robot's copy is in the sections.
+ */
+typedef struct {
+    const kilobot_program_t *program;  //  the program
+    size_t data_size, bss_size;        //  sizes of its .data and .bss
+    uint8_t *pristine;                 //  contents of both before any robot ran
+    struct robot *resident;            //  robot whose copy is in the sections now, NULL if pristine
+    uint8_t *arena;                    //  one slot per robot running the program
+    size_t stride;                     //  size of a slot, a multiple of the cache line
+    int slots, capacity;               //  used and allocated slots
+} world_image_t;
+
+/**
+ * @brief One simulated kilobot.
+ */
+typedef struct robot {
+    int id;                             //  index in the world, also the kilo_uid
+    struct world *world;                //  world the robot lives in
+    const kilobot_program_t *program;   //  program the robot runs
+    task_t *task;                       //  flow of control of the program
+    kilo_host_cpu_t cpu;                //  kilolib state of the robot
+    world_image_t *image;               //  variables of the program
+    int slot;                           //  the robot's copy of them in the image's arena
+    int halted;                         //  the program's main() returned
+
+    const ir_profile_t *ir;             //  response of the IR receiver
+
+    kilo_cycles_t wake_at;              //  end of the current delay()
+    uint8_t waiting;                    //  suspended in delay() rather than between two loop() calls
+    uint32_t timer_quiet;               //  timer0 interrupts that cannot transmit before the next one that can
+    uint8_t timer_ocr;                  //  OCR0A value of the pending timer0 compare match
+    kilo_cycles_t timer_next;           //  next timer0 compare match
+    uint32_t rng_draws[KILO_RNG_STREAMS];  //  numbers drawn from each random stream
+    uint32_t rng_seeds[KILO_RNG_STREAMS];  //  sequence of each random stream, see kilo_host_random_seed()
+    world_burst_t bursts[WORLD_BURSTS]; //  last emissions of the IR LED, oldest overwritten first
+    uint8_t bursts_next;                //  slot of the next emission
+    kilo_cycles_t stalled;              //  cycles spent in message_send() with interrupts off
+    world_near_t *near;                 //  robots in range when the robot last transmitted, in grid order
+    uint32_t near_n, near_cap;
+    uint32_t near_at;                   //  grid clock when near was filled, 0 if never
+
+    uint32_t messages_sent;             //  frames transmitted
+    uint32_t messages_aborted;          //  transmissions abandoned because carrier sense found the channel busy
+    uint32_t messages_received;         //  frames handed to kilo_message_rx
+    uint32_t messages_lost;             //  frames in range that a collision corrupted
+    uint32_t messages_dropped;          //  frames heard while KILO_RX_QUEUE frames waited, see kilo_host_rx_push()
+} robot_t;
+
+/**
+ * @brief The simulated arena.
+ */
+typedef struct world {
+    world_config_t config;   //  settings of the run
+    kilo_cycles_t now;       //  current simulated time
+    int n;                   //  number of robots
+    int capacity;            //  allocated size of robots
+    robot_t **robots;        //  the robots, indexed by id
+    bodies_t bodies;         //  their hot state
+    ir_profile_t *ir;        //  receivers of the swarm, IR_PROFILES of them
+    grid_t grid;             //  positions of the robots, for IR neighbor queries
+    sched_t sched;           //  robots by time of their next event
+    int moving;              //  robots with a motor on
+    int32_t *pushed;         //  robots moved by a collision in the last world step
+    uint32_t pushed_n, pushed_cap;
+    world_check_t *checks;   //  robots the collision pass checks, by grid region when it runs in parallel
+    uint32_t checks_n, checks_cap;
+    kilo_cycles_t stepped_at;  //  time of the last world step
+    world_tx_t *tx;          //  transmissions since the last world step, in order
+    int tx_n, tx_cap;
+    pool_t *pool;            //  workers of the world passes, NULL when single-threaded
+    world_scratch_t *scratch;  //  one per worker
+    world_image_t **images;  //  one per program
+    int images_n;
+    trace_t *trace;          //  where to record the run, NULL if it is not traced
+    uint32_t branch;         //  continuation of the run since world_fork(), 0 before (or without) it
+} world_t;
+
+/**
+ * @brief Create an empty world.
+ *
+ * @param config (Settings of the run)
+ * @return world_t* (New world, or NULL on failure)
+ */
+world_t *world_create(const world_config_t *config);
+
+/**
+ * @brief Add a robot running @p program at the given pose.
+ *
+ * The robot gets the next free kilo_uid and a calibration derived from the
+ * run seed; its program starts on the first world_run().
+ *
+ * @param w (World)
+ * @param program (Program to run)
+ * @param x (Position, mm)
+ * @param y (Position, mm)
+ * @param theta (Heading, rad)
+ * @return robot_t* (New robot, or NULL on failure)
+ */
+robot_t *world_add_robot(world_t *w, const kilobot_program_t *program, double x, double y, double theta);
+
+/**
+ * @brief Advance the simulation up to time @p until.
+ *
+ * @param w (World)
+ * @param until (Simulated time to stop at, in cycles)
+ */
+void world_run(world_t *w, kilo_cycles_t until);
+
+/**
+ * @brief Branch the run: continue it from the current state in @p branches child processes.
+ *
+ * Each child starts as a copy-on-write copy of this process (fork()): poses,
+ * the memory and stack of every robot's program, random streams, frames on
+ * the channel and the trace so far, so the common opening is simulated only
+ * once. From then on branch k (1 to @p branches) draws other random numbers
+ * than the run and the other branches, so the branches diverge. At most
+ * @p jobs children run at a time, each with as many workers as the world.
+ *
+ * @param w (World, between two world_run())
+ * @param branches (Number of branches)
+ * @param jobs (Children running at a time)
+ * @return int (In a child, its branch. In the parent, once every child has exited: 0 if they all exited with status 0, else -1)
+ */
+int world_fork(world_t *w, int branches, int jobs);
+
+/**
+ * @brief Destroy a world and all its robots.
+ *
+ * @param w (World)
+ */
+void world_destroy(world_t *w);
+
+#endif//__WORLD_H__
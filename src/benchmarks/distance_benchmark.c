@@ -0,0 +1,139 @@
+/**
+ * @file distance_benchmark.c
+ * @author Joseph Katakam (jkatak73@terpmail.umd.edu)
+ *
+ * @brief Times estimate_distance() on a kilobot, in CPU cycles, against the versions it replaced
+ *
+ * Prints the cycles of estimate_distance() (segments looked up in
+ * kilo_distance_lut), estimate_distance_scan() (tables scanned, one division
+ * per channel) and estimate_distance_reference() (floating point). Their
+ * flash is listed by "avr-nm --size-sort -S build/distance_benchmark.elf":
+ * the floating point one also pulls in the soft-float routines (__addsf3,
+ * __mulsf3, __divsf3, __fixsfsi, __floatsisf, ...).
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+// kilolib library
+#include "../../kilolib/kilolib.h"
+#include "../../kilolib/distance.h"
+#include "../../kilolib/distance_reference.h"
+#define DEBUG
+#include "../../kilolib/debug.h"
+
+#ifdef SIMULATOR
+#error "distance_benchmark.c counts AVR cycles: build it with make FILENAME=distance_benchmark.c"
+#endif
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#define HIGH_STEP 4     // high gain readings timed: 0, 4, ... 1020
+#define LOW_STEP  64    // low gain readings timed with each of them: 0, 64, ... 960
+
+/**
+ * @brief Cycles taken by the calls of one version.
+ */
+typedef struct {
+    uint32_t total;
+    uint16_t min;
+    uint16_t max;
+} timing_t;
+
+/**
+ * @brief Does nothing, to time the cost of the call and of the timer itself
+ *
+ * @param d (Unused)
+ * @return uint8_t (0)
+ */
+static uint8_t no_estimate(const distance_measurement_t *d) {
+    return 0;
+}
+
+/**
+ * @brief Times one call with Timer1, interrupts disabled
+ *
+ * Timer1 otherwise times receptions: one under way is lost, which is all
+ * the same here since nothing is sent to this robot.
+ *
+ * @param f (Version to time)
+ * @param d (Readings)
+ * @param out (Receives the distance)
+ * @return uint16_t (Cycles, call included)
+ */
+static uint16_t time_call(uint8_t (*f)(const distance_measurement_t *), const distance_measurement_t *d, uint8_t *out) {
+    uint16_t cycles;
+
+    cli();
+    TCNT1 = 0;
+    TCCR1B = 1;  // one count per cycle
+    *out = f(d);
+    cycles = TCNT1;
+    TCCR1B = 0;
+    TCNT1 = 0;
+    sei();
+    return cycles;
+}
+
+/**
+ * @brief Adds a call to a timing
+ *
+ * @param t (Timing)
+ * @param cycles (Cycles of the call, overhead removed)
+ */
+static void add(timing_t *t, uint16_t cycles) {
+    t->total += cycles;
+    if (cycles < t->min)
+        t->min = cycles;
+    if (cycles > t->max)
+        t->max = cycles;
+}
+
+/**
+ * @brief Prints a timing
+ *
+ * @param name (Version)
+ * @param t (Timing)
+ * @param calls (Calls timed)
+ */
+static void report(const char *name, const timing_t *t, uint16_t calls) {
+    printf("%s: %u min, %lu mean, %u max cycles\n", name, t->min, (unsigned long)(t->total / calls), t->max);
+}
+
+void setup() {
+    timing_t table = {0, 0xFFFF, 0}, scan = {0, 0xFFFF, 0}, reference = {0, 0xFFFF, 0};
+    distance_measurement_t d;
+    uint16_t overhead, calls = 0, differ = 0;
+    uint8_t a, b, c;
+
+    overhead = time_call(no_estimate, &d, &a);
+    for (d.high_gain = 0; d.high_gain < 1024; d.high_gain += HIGH_STEP) {
+        for (d.low_gain = 0; d.low_gain < 1024; d.low_gain += LOW_STEP) {
+            add(&table, time_call(estimate_distance, &d, &a) - overhead);
+            add(&scan, time_call(estimate_distance_scan, &d, &b) - overhead);
+            add(&reference, time_call(estimate_distance_reference, &d, &c) - overhead);
+            differ += a != c || b != c;
+            calls++;
+        }
+    }
+    printf("%u readings, %u estimates differ, table %s (%u bytes of RAM)\n",
+           calls, differ, kilo_distance_lut.ready ? "used" : "unusable", (unsigned)sizeof(kilo_distance_lut));
+    report("table         ", &table, calls);
+    report("scan          ", &scan, calls);
+    report("floating point", &reference, calls);
+}
+
+void loop() {
+    set_color(RGB(0, 1, 0));  // done
+}
+
+int main() {
+    kilo_init();
+    debug_init();
+    kilo_start(setup, loop);
+
+    return 0;
+}
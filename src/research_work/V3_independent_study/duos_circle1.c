@@ -34,15 +34,33 @@
  * The number of kilobots should be an even number, as the DUOs exist as pairs.
  * 
  */
+#ifndef ROBOTS_IN_FIRST_CIRCLE  // the constants of this file can be set from the command line (-D), see sim/sweep.sh
 #define ROBOTS_IN_FIRST_CIRCLE 4
+#endif
 #define ROBOTS_IN_SECOND_CIRCLE 10
+#ifndef TOTAL_KILOBOTS
 #define TOTAL_KILOBOTS 4  // Value 1: 16robots, Value 2: 32robots, Value 3: 48robots, Value 4: 64robots
+#endif
 
 // Parameters for Circle formation
+#ifndef DESIRED_DISTANCE
 #define DESIRED_DISTANCE  55
+#endif
+#ifndef EPSILON
 #define EPSILON           15
+#endif
 // #define MIN_DISTANCE      35  // Not used
+#ifndef MAX_DISTANCE
 #define MAX_DISTANCE      90
+#endif
+
+// Timeouts (kilo_ticks, 32 per second)
+#ifndef SILENT_TICKS
+#define SILENT_TICKS      (32 * 10)  // without a message before the kilobot moves on its own
+#endif
+#ifndef LOST_TICKS
+#define LOST_TICKS        (32 * 30)  // between two turns of a kilobot that hears nobody
+#endif
 
 // LED colors (Used as debugging mechanism)
 #define LED_OFF          RGB(0, 0, 0)  // [INDICATION]: kilobot not in communication range
@@ -528,13 +546,13 @@ void loop() {
 
 //------------------------------------------------------------------------------------------------------------
     // [CASE]: when kilobot has not received message for a long period
-    if ((kilo_ticks - g->timer > 32 * 10 || kilo_ticks == 32 * 15) && g->my_stop_status == 0) {
+    if ((kilo_ticks - g->timer > SILENT_TICKS || kilo_ticks == 32 * 15) && g->my_stop_status == 0) {
         set_color(LED_OFF);  // [INDICATION]: kilobot not in communication range
         move(FORWARD, 500);  // [MOTOR ACTION]: Move straight
         // g->my_stop_status=0;
 
         // [CASE]: when kilobot has not received message for a very long period
-        if (kilo_ticks > g->last_changed + 32 * 30) {
+        if (kilo_ticks > g->last_changed + LOST_TICKS) {
             // [UPDATE]: kiloticks
             g->last_changed = kilo_ticks;
 
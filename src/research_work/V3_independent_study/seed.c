@@ -29,7 +29,9 @@
  *                                   Maximum: 10 or 12
  * 
  */
+#ifndef NUMBER_OF_ROBOTS
 #define NUMBER_OF_ROBOTS 8
+#endif
 
 
 // LED colors